@@ -51,6 +51,7 @@ class wxChartPanel;
 #include <wx/window.h>
 #include <wx/toplevel.h>
 #include <vector>
+#include "rjmcmc/util/checkpoint.hpp"
 
 #define OVERALL_ACCEPTANCE
 
@@ -72,6 +73,9 @@ namespace simulated_annealing {
 
             void init(int dump, int);
 
+            friend void save_state(std::ostream&, const chart_visitor&) {}
+            friend void load_state(std::istream&, chart_visitor&) {}
+
             template<typename Configuration, typename Sampler>
             void begin(const Configuration& config, const Sampler& sampler, double t)
             {
@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <wx/wx.h>
 #include <wx/aboutdlg.h>
 #include "rjmcmc/util/variant.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 #include "paint/all.hpp"
 #include "rjmcmc/geometry/geometry.hpp"
 #include <GilViewer/gui/panel_viewer.hpp>
@@ -88,6 +89,9 @@ namespace simulated_annealing {
 
             void init(int dump, int save);
 
+            friend void save_state(std::ostream&, const configuration_visitor&) {}
+            friend void load_state(std::istream&, configuration_visitor&) {}
+
             template<typename Configuration, typename Sampler>
             void begin(const Configuration& config, const Sampler&, double)
             {
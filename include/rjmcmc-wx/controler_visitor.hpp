@@ -41,6 +41,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <wx/bmpbuttn.h>
 
 #include <boost/shared_ptr.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 class wxAuiManager;
 
 namespace simulated_annealing {
@@ -67,6 +68,9 @@ namespace simulated_annealing {
 
             void init(int, int) {}
 
+            friend void save_state(std::ostream&, const controler_visitor&) {}
+            friend void load_state(std::istream&, controler_visitor&) {}
+
             template<typename Configuration, typename Sampler>
             void begin(const Configuration& config, const Sampler& sampler, double t)
             {
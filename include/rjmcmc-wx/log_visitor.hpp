@@ -57,6 +57,9 @@ namespace simulated_annealing {
                 log();
             }
 
+            friend void save_state(std::ostream& os, const log_visitor& v) { save_state(os,v.m_visitor); }
+            friend void load_state(std::istream& is, log_visitor& v) { load_state(is,v.m_visitor); }
+
             template<typename Configuration, typename Sampler>
             void begin(const Configuration& config, const Sampler& sampler, double t)
             {
@@ -43,6 +43,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #endif
 
 #include <boost/shared_ptr.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 #include <wx/window.h>
 #include <wx/toplevel.h>
 
@@ -72,6 +73,9 @@ namespace simulated_annealing {
 
             void init(int, int) {}
 
+            friend void save_state(std::ostream&, const parameters_visitor&) {}
+            friend void load_state(std::istream&, parameters_visitor&) {}
+
             template<typename Configuration, typename Sampler>
             void begin(const Configuration&, const Sampler&, double)
             {
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define GEOMETRY_CIRCLE_2_HPP
 
 #include "geometry.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 
 #if USE_CGAL
 
@@ -109,6 +110,21 @@ operator>>(std::istream &is, Circle_2<K> &b)
 	return is;
 }
 
+template < class K >
+void save_state(std::ostream &os, const Circle_2<K> &c)
+{
+	double v[3] = { to_double(c.center().x()), to_double(c.center().y()), to_double(c.radius()) };
+	os.write(reinterpret_cast<const char *>(v), sizeof(v));
+}
+
+template < class K >
+void load_state(std::istream &is, Circle_2<K> &c)
+{
+	double v[3];
+	if (is.read(reinterpret_cast<char *>(v), sizeof(v)))
+		c = Circle_2<K>(typename K::Point_2(v[0],v[1]), v[2]);
+}
+
 template<class K>
 typename K::FT radius(const Circle_2<K>& c) {
 	return c.radius();
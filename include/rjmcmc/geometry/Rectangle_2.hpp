@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <vector>
 
 #include "geometry.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace geometry {
 /**
@@ -271,7 +272,7 @@ public:
     FT rs = abs(r);
     FT dx = nx+rs*ny;
     FT dy = ny+rs*nx;
-    return Iso_Rectangle_2(c.x()-dx,c.y()-dy,c.x()+dx,c.y()+dy);
+    return Iso_rectangle_2(c.x()-dx,c.y()-dy,c.x()+dx,c.y()+dy);
   }
 
   // returns the positive scale so that q in on the boundary of "scaled this"
@@ -418,6 +419,25 @@ operator>>(std::istream &is, Rectangle_2<R> &b)
   return is;
 }
 
+/****************************************/
+/*         Checkpoint hooks             */
+/****************************************/
+
+template < class R >
+void save_state(std::ostream &os, const Rectangle_2<R> &r)
+{
+  double v[5] = { to_double(r.center().x()), to_double(r.center().y()), to_double(r.normal().x()), to_double(r.normal().y()), to_double(r.ratio()) };
+  os.write(reinterpret_cast<const char *>(v), sizeof(v));
+}
+
+template < class R >
+void load_state(std::istream &is, Rectangle_2<R> &r)
+{
+  double v[5];
+  if (is.read(reinterpret_cast<char *>(v), sizeof(v)))
+    r = Rectangle_2<R>(typename R::Point_2(v[0],v[1]), typename R::Vector_2(v[2],v[3]), v[4]);
+}
+
 }; // namespace geometry
 
 #endif // GEOMETRY_RECTANGLE_2_HPP
@@ -80,6 +80,21 @@ namespace geometry {
             return 1.;
         }
 
+        // delayed rejection support (see rjmcmc::delayed_rejection_kernel)
+        // variate leaving the rectangle unchanged
+        template<typename IteratorIn,typename IteratorOut>
+        inline void neutral_variate(IteratorIn, IteratorOut out) const {
+            *out++ = 0.5;
+            *out++ = 0.5;
+        }
+
+        // variate of the move from the rectangle proposed with var2 to the one proposed with var1 : translations compose
+        template<typename IteratorIn,typename IteratorOut>
+        inline void ghost_variate(IteratorIn, IteratorIn var1, IteratorIn var2, IteratorOut out) const {
+            *out++ = var1[0]-var2[0]+0.5;
+            *out++ = var1[1]-var2[1]+0.5;
+        }
+
     private:
         double m_d;
     };
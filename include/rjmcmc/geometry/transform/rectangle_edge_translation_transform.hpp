@@ -103,6 +103,21 @@ namespace geometry {
             // maxima rot90: abs(determinant(jacobian([x,y,-r*v,r*u,p,1/r],[x,y,u,v,r,p]))) = 1;
             return 1;
         }
+
+        // delayed rejection support (see rjmcmc::delayed_rejection_kernel)
+        // variate leaving the rectangle of coordinates `in` unchanged
+        template<typename IteratorIn,typename IteratorOut>
+        inline void neutral_variate(IteratorIn in, IteratorOut out) const {
+            typedef typename std::iterator_traits<IteratorIn>::value_type FT;
+            FT r = in[4];
+            *out = ((N<2 ? r : 1./r)-m_rmin)/m_rrange;
+        }
+
+        // variate of the move from the rectangle proposed from `in` with var2 to the one proposed with var1 : the ratio is absolute
+        template<typename IteratorIn,typename IteratorOut>
+        inline void ghost_variate(IteratorIn, IteratorIn var1, IteratorIn, IteratorOut out) const {
+            *out = *var1;
+        }
     };
 
 }
@@ -0,0 +1,347 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef AABB_TREE_ACCELERATOR_HPP
+#define AABB_TREE_ACCELERATOR_HPP
+
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include "rjmcmc/util/static_vector.hpp"
+#include "grid_accelerator.hpp" // bounding_box
+
+namespace marked_point_process {
+
+    namespace internal {
+        template<typename Iterator> class aabb_tree_index;
+    }
+
+    /**
+     * Accelerator indexing the objects of a configuration in a dynamic tree of axis aligned bounding boxes :
+     * each leaf holds the bounding box of an object, each inner node the union of the boxes of its two children.
+     * Insertions choose the sibling of the new leaf that least increases the perimeters of the tree, and the boxes
+     * and heights of the ancestors of an inserted or removed leaf are refitted incrementally, with rotations that keep the tree balanced.
+     * As opposed to the grid_accelerator, queries, insertions and removals are logarithmic whatever the sizes of the objects
+     * and no domain has to be provided. A query only reports the objects whose bounding box overlaps the bounding box of the
+     * query object, enlarged by `margin` : it is exact as long as objects interact only if their bounding boxes are closer than `margin`.
+     * Objects are required to be of a single type, with a bounding_box overload (by default their bbox() member).
+     */
+    class aabb_tree_accelerator
+    {
+    public:
+        template<typename Iterator> struct rebind { typedef internal::aabb_tree_index<Iterator> other; };
+
+        aabb_tree_accelerator(double margin = 0) : m_margin(margin) {}
+
+    protected:
+        double m_margin;
+    };
+
+    namespace internal {
+
+        template<typename Iterator>
+        class aabb_tree_index : private aabb_tree_accelerator
+        {
+            enum { null_node = -1, max_depth = 64 };
+            typedef rjmcmc::static_vector<int,max_depth> stack_type;
+
+            struct aabb
+            {
+                double b[4];
+                inline bool overlaps(const aabb& a) const { return !(a.b[0]>b[2] || a.b[2]<b[0] || a.b[1]>b[3] || a.b[3]<b[1]); }
+                inline bool contains(const aabb& a) const { return b[0]<=a.b[0] && b[1]<=a.b[1] && a.b[2]<=b[2] && a.b[3]<=b[3]; }
+                inline double perimeter() const { return 2*((b[2]-b[0])+(b[3]-b[1])); }
+                inline aabb merge(const aabb& a) const
+                {
+                    aabb m;
+                    m.b[0] = (std::min)(b[0],a.b[0]); m.b[1] = (std::min)(b[1],a.b[1]);
+                    m.b[2] = (std::max)(b[2],a.b[2]); m.b[3] = (std::max)(b[3],a.b[3]);
+                    return m;
+                }
+            };
+
+            // leaves have no children, free nodes are chained through their parent
+            struct node
+            {
+                aabb m_box;
+                int m_parent, m_left, m_right, m_height;
+                Iterator m_it;
+                inline bool leaf() const { return m_left==null_node; }
+            };
+
+        public:
+            // iterator over the candidates of a query : a depth first traversal of the nodes overlapping the query box
+            class iterator : public boost::iterator_facade<iterator, const Iterator, boost::forward_traversal_tag>
+            {
+            public:
+                iterator() : m_index(NULL), m_box(), m_node(null_node) {}
+                iterator(const aabb_tree_index *index, const aabb& box) : m_index(index), m_box(box), m_node(null_node)
+                {
+                    if(m_index->m_root!=null_node) m_stack.push_back(m_index->m_root);
+                    increment();
+                }
+                // past-the-end iterator of a query
+                iterator(const aabb_tree_index *index) : m_index(index), m_box(), m_node(null_node) {}
+
+            private:
+                friend class boost::iterator_core_access;
+
+                inline const Iterator& dereference() const { return m_index->m_nodes[m_node].m_it; }
+                inline bool equal(const iterator& it) const { return m_node==it.m_node; }
+
+                void increment()
+                {
+                    while(!m_stack.empty())
+                    {
+                        const node& n = m_index->m_nodes[m_stack.back()];
+                        int i = m_stack.back();
+                        m_stack.pop_back();
+                        if(!n.m_box.overlaps(m_box)) continue;
+                        if(n.leaf()) { m_node = i; return; }
+                        assert(m_stack.size()+2<=max_depth);
+                        m_stack.push_back(n.m_right);
+                        m_stack.push_back(n.m_left);
+                    }
+                    m_node = null_node;
+                }
+
+                const aabb_tree_index *m_index;
+                aabb m_box;
+                stack_type m_stack;
+                int m_node;
+            };
+
+            aabb_tree_index(const aabb_tree_accelerator& a) : aabb_tree_accelerator(a), m_root(null_node), m_free(null_node) {}
+
+            template<typename C, typename T> std::pair<iterator,iterator> operator()(const C &, const T &t) const
+            {
+                aabb box;
+                bounding_box(t,box.b);
+                box.b[0] -= m_margin; box.b[1] -= m_margin; box.b[2] += m_margin; box.b[3] += m_margin;
+                return std::make_pair(iterator(this,box),iterator(this));
+            }
+
+            template<typename V> void insert(const V& v, Iterator it)
+            {
+                int leaf = allocate();
+                node& n = m_nodes[leaf];
+                bounding_box(v,n.m_box.b);
+                n.m_left = n.m_right = null_node;
+                n.m_height = 0;
+                n.m_it = it;
+                insert_leaf(leaf);
+            }
+
+            // the leaf of it is looked for among the nodes whose box contains the bounding box of v
+            template<typename V> void remove(const V& v, Iterator it)
+            {
+                aabb box;
+                bounding_box(v,box.b);
+                int leaf = find(box,it);
+                if(leaf==null_node) return;
+                remove_leaf(leaf);
+                release(leaf);
+            }
+
+            // empties the tree but keeps the capacity of its node pool
+            void clear()
+            {
+                m_nodes.clear();
+                m_root = m_free = null_node;
+            }
+
+            inline int height() const { return m_root==null_node ? 0 : m_nodes[m_root].m_height; }
+
+        private:
+            int allocate()
+            {
+                if(m_free==null_node) { m_nodes.push_back(node()); return int(m_nodes.size())-1; }
+                int i = m_free;
+                m_free = m_nodes[i].m_parent;
+                return i;
+            }
+            inline void release(int i)
+            {
+                m_nodes[i].m_parent = m_free;
+                m_free = i;
+            }
+
+            int find(const aabb& box, Iterator it) const
+            {
+                if(m_root==null_node) return null_node;
+                stack_type stack;
+                stack.push_back(m_root);
+                while(!stack.empty())
+                {
+                    int i = stack.back();
+                    stack.pop_back();
+                    const node& n = m_nodes[i];
+                    if(!n.m_box.contains(box)) continue;
+                    if(n.leaf()) { if(n.m_it==it) return i; continue; }
+                    assert(stack.size()+2<=max_depth);
+                    stack.push_back(n.m_right);
+                    stack.push_back(n.m_left);
+                }
+                return null_node;
+            }
+
+            void insert_leaf(int leaf)
+            {
+                if(m_root==null_node) { m_root = leaf; m_nodes[leaf].m_parent = null_node; return; }
+
+                // descend towards the sibling that minimizes the perimeter increase of the tree
+                const aabb box = m_nodes[leaf].m_box;
+                int i = m_root;
+                while(!m_nodes[i].leaf())
+                {
+                    const node& n = m_nodes[i];
+                    double perimeter = n.m_box.perimeter();
+                    double combined  = n.m_box.merge(box).perimeter();
+                    double cost = 2*combined; // cost of making the new leaf the sibling of n
+                    double inheritance = 2*(combined-perimeter); // cost of pushing the leaf further down
+                    double cost_left  = descent_cost(n.m_left ,box)+inheritance;
+                    double cost_right = descent_cost(n.m_right,box)+inheritance;
+                    if(cost<cost_left && cost<cost_right) break;
+                    i = (cost_left<cost_right) ? n.m_left : n.m_right;
+                }
+
+                int sibling = i;
+                int old_parent = m_nodes[sibling].m_parent;
+                int new_parent = allocate();
+                node& p = m_nodes[new_parent];
+                p.m_parent = old_parent;
+                p.m_box = box.merge(m_nodes[sibling].m_box);
+                p.m_height = m_nodes[sibling].m_height+1;
+                p.m_left = sibling;
+                p.m_right = leaf;
+                if(old_parent==null_node) m_root = new_parent;
+                else replace_child(old_parent,sibling,new_parent);
+                m_nodes[sibling].m_parent = new_parent;
+                m_nodes[leaf].m_parent = new_parent;
+
+                refit(m_nodes[leaf].m_parent);
+            }
+
+            void remove_leaf(int leaf)
+            {
+                if(leaf==m_root) { m_root = null_node; return; }
+                int parent = m_nodes[leaf].m_parent;
+                int grand_parent = m_nodes[parent].m_parent;
+                int sibling = (m_nodes[parent].m_left==leaf) ? m_nodes[parent].m_right : m_nodes[parent].m_left;
+                m_nodes[sibling].m_parent = grand_parent;
+                release(parent);
+                if(grand_parent==null_node) { m_root = sibling; return; }
+                replace_child(grand_parent,parent,sibling);
+                refit(grand_parent);
+            }
+
+            inline double descent_cost(int i, const aabb& box) const
+            {
+                const node& n = m_nodes[i];
+                double perimeter = n.m_box.merge(box).perimeter();
+                return n.leaf() ? perimeter : perimeter-n.m_box.perimeter();
+            }
+
+            inline void replace_child(int parent, int old_child, int new_child)
+            {
+                node& p = m_nodes[parent];
+                if(p.m_left==old_child) p.m_left = new_child;
+                else                    p.m_right = new_child;
+            }
+
+            inline void update(int i)
+            {
+                node& n = m_nodes[i];
+                const node& l = m_nodes[n.m_left];
+                const node& r = m_nodes[n.m_right];
+                n.m_height = 1+(std::max)(l.m_height,r.m_height);
+                n.m_box = l.m_box.merge(r.m_box);
+            }
+
+            // rebalances and updates the ancestors of a modified subtree, from i up to the root
+            void refit(int i)
+            {
+                while(i!=null_node)
+                {
+                    i = balance(i);
+                    update(i);
+                    i = m_nodes[i].m_parent;
+                }
+            }
+
+            // if the heights of the children of a differ by more than one, the higher child b is rotated up,
+            // a taking the place of b and adopting its lower child. returns the root of the subtree.
+            int balance(int a)
+            {
+                if(m_nodes[a].leaf() || m_nodes[a].m_height<2) return a;
+                int left = m_nodes[a].m_left, right = m_nodes[a].m_right;
+                int diff = m_nodes[right].m_height-m_nodes[left].m_height;
+                if(diff> 1) return rotate(a,right);
+                if(diff<-1) return rotate(a,left);
+                return a;
+            }
+
+            int rotate(int a, int b)
+            {
+                int f = m_nodes[b].m_left, g = m_nodes[b].m_right;
+                if(m_nodes[f].m_height>m_nodes[g].m_height) std::swap(f,g); // b keeps g, the higher child
+
+                m_nodes[b].m_left = a;
+                m_nodes[b].m_right = g;
+                m_nodes[b].m_parent = m_nodes[a].m_parent;
+                m_nodes[a].m_parent = b;
+                if(m_nodes[b].m_parent==null_node) m_root = b;
+                else replace_child(m_nodes[b].m_parent,a,b);
+
+                if(m_nodes[a].m_left==b) m_nodes[a].m_left = f;
+                else                     m_nodes[a].m_right = f;
+                m_nodes[f].m_parent = a;
+                update(a);
+                update(b);
+                return b;
+            }
+
+            std::vector<node> m_nodes;
+            int m_root, m_free;
+        };
+
+    }; // namespace internal
+
+}; // namespace marked_point_process
+
+#endif // AABB_TREE_ACCELERATOR_HPP
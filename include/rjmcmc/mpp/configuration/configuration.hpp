@@ -38,27 +38,64 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RJMCMC_CONFIGURATION_HPP
 
 #include <vector>
+#include <iterator>
+#include <boost/iterator/counting_iterator.hpp>
 
 namespace marked_point_process {
     //////////////////////////////////////////////////////////
-    
+
+    /// the object of index i in [0,c.size()) (default : the i-th object from c.begin(), in linear time).
+    /// Configurations that maintain a random access table override it with an overload found by argument dependent lookup.
+    template<typename Configuration>
+    inline typename Configuration::const_iterator object_at(const Configuration &c, size_t i)
+    {
+        typename Configuration::const_iterator it = c.begin();
+        std::advance(it, i);
+        return it;
+    }
+
+    /// removes the objects [first,last) of c (default : one at a time, in order, which requires removals not to invalidate the other iterators).
+    /// Configurations whose removals move objects override it with an overload found by argument dependent lookup.
+    template<typename Configuration, typename Iterator>
+    inline void remove_all(Configuration &c, Iterator first, Iterator last)
+    {
+        for(; first!=last; ++first) c.remove(*first);
+    }
+
+    namespace internal {
+        template<typename Iterator> class trivial_index;
+    }
+
+    // An accelerator is a prototype, rebound by the configuration to the index type that tracks its Iterator type :
+    // index(accelerator) builds an empty index, index.insert(value,it) and index.remove(value,it) keep it in sync with
+    // the configuration, index.clear() empties it and index(c,t) returns a range of iterators of c that contains all the objects interacting with t.
     struct trivial_accelerator {
+        template<typename Iterator> struct rebind { typedef internal::trivial_index<Iterator> other; };
+
 	template<typename C, typename T> std::pair<typename C::iterator,typename C::iterator> operator()(const C &c, const T &t) const {
             return std::make_pair(c.begin(),c.end());
 	}
     };
     
     namespace internal {
+        // index of the trivial accelerator : the whole range of objects, nothing to keep in sync
+        template<typename Iterator> class trivial_index {
+        public:
+            typedef boost::counting_iterator<Iterator> iterator;
+            trivial_index(const trivial_accelerator&) {}
+            template<typename C, typename T> inline std::pair<iterator,iterator> operator()(const C &c, const T &) const {
+                return std::make_pair(iterator(c.begin()),iterator(c.end()));
+            }
+            template<typename V> inline void insert(const V&, Iterator) {}
+            template<typename V> inline void remove(const V&, Iterator) {}
+            inline void clear() {}
+        };
+
         template<typename C> struct inserter {
             C& c_;
             inserter(C& c) : c_(c) {}
             template<typename T> void operator()(T& t) const { c_.insert(t); }
         };
-        template<typename C> struct remover {
-            C& c_;
-            remover(C& c) : c_(c) {}
-            template<typename T> void operator()(T& t) const { c_.remove(t); }
-        };
         
         
         template<
@@ -79,7 +116,7 @@ namespace marked_point_process {
             // manipulators
             inline void apply(Configuration &c) const
             {
-                std::for_each(m_death.begin(),m_death.end(),internal::remover <Configuration>(c));
+                remove_all(c,m_death.begin(),m_death.end());
                 std::for_each(m_birth.begin(),m_birth.end(),internal::inserter<Configuration>(c));
             }
 
@@ -0,0 +1,594 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef FLAT_GRAPH_CONFIGURATION_HPP
+#define FLAT_GRAPH_CONFIGURATION_HPP
+
+#include <set>
+#include <cassert>
+#include <vector>
+#include <boost/tuple/tuple.hpp> // tie
+#include <boost/iterator/iterator_facade.hpp>
+#include "configuration.hpp"
+#include "rjmcmc/util/static_vector.hpp"
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/rjmcmc/energy/energy.hpp" // is_non_negative
+
+
+namespace marked_point_process {
+
+    /**
+     * Configuration with the interface of graph_configuration, stored in flat arrays rather than in a boost adjacency list.
+     * Objects live in the slots of a slot map : the values, unary energies and neighbour lists are stored in separate arrays
+     * indexed by slot, and removed slots are recycled through a free list, so that the handle of an object (its slot) is stable.
+     * Each slot holds a contiguous array of its neighbours with the cached binary energies, so that the scans of delta_death()
+     * and remove() do not chase pointers.
+     * Iterators visit the occupied slots in increasing order. As rollback() reuses the very slots of the removed objects,
+     * iterators to objects present at begin_transaction() remain valid after a rollback().
+     * A dense table of the handles, maintained by swapping with its last entry, provides object_at() in constant time.
+     */
+    template<typename T, typename UnaryEnergy, typename BinaryEnergy, typename Accelerator=trivial_accelerator>
+    class flat_graph_configuration
+    {
+    public:
+	typedef flat_graph_configuration<T,UnaryEnergy, BinaryEnergy, Accelerator> self;
+        typedef T	value_type;
+        typedef UnaryEnergy	unary_energy_type;
+        typedef BinaryEnergy	binary_energy_type;
+        typedef Accelerator	accelerator_type;
+        typedef unsigned int	handle_type;
+    private:
+        struct neighbour {
+            neighbour(handle_type s, double e) : m_slot(s), m_energy(e) {}
+            handle_type m_slot;
+            double m_energy;
+        };
+        typedef std::vector<neighbour> neighbour_list;
+
+    public:
+        // iterator over the occupied slots, dereferencing to their handles
+        class slot_iterator : public boost::iterator_facade<slot_iterator, const handle_type, boost::forward_traversal_tag>
+        {
+        public:
+            slot_iterator() : m_c(NULL), m_slot(0) {}
+            slot_iterator(const self *c, handle_type s) : m_c(c), m_slot(s) {}
+        private:
+            friend class boost::iterator_core_access;
+            inline const handle_type& dereference() const { return m_slot; }
+            inline bool equal(const slot_iterator& it) const { return m_slot==it.m_slot; }
+            inline void increment() { m_slot = m_c->next(m_slot+1); }
+            const self *m_c;
+            handle_type m_slot;
+        };
+
+        // iterator over the interactions, each reported once from its lower slot, dereferencing to the pair of handles
+        class interaction_iterator : public boost::iterator_facade<interaction_iterator, std::pair<handle_type,handle_type>,
+                boost::forward_traversal_tag, std::pair<handle_type,handle_type> >
+        {
+        public:
+            interaction_iterator() : m_c(NULL), m_slot(0), m_k(0) {}
+            interaction_iterator(const self *c, handle_type s) : m_c(c), m_slot(s), m_k(0) { if(!found()) increment(); }
+        private:
+            friend class boost::iterator_core_access;
+            friend class flat_graph_configuration;
+            inline std::pair<handle_type,handle_type> dereference() const { return std::make_pair(m_slot,m_c->m_neighbours[m_slot][m_k].m_slot); }
+            inline bool equal(const interaction_iterator& it) const { return m_slot==it.m_slot && m_k==it.m_k; }
+            inline bool found() const
+            {
+                if(m_slot>=m_c->m_live.size()) return true; // end
+                const neighbour_list& n = m_c->m_neighbours[m_slot];
+                return m_c->m_live[m_slot] && m_k<n.size() && m_slot<n[m_k].m_slot;
+            }
+            void increment()
+            {
+                do {
+                    if(++m_k<m_c->m_neighbours[m_slot].size()) continue;
+                    m_k = 0;
+                    if(++m_slot>=m_c->m_live.size()) return;
+                } while(!found());
+            }
+            const self *m_c;
+            handle_type m_slot;
+            size_t m_k;
+        };
+
+	typedef	slot_iterator	iterator;
+	typedef	slot_iterator	const_iterator;
+	typedef interaction_iterator	edge_iterator;
+	typedef interaction_iterator	const_edge_iterator;
+        typedef typename Accelerator::template rebind<const_iterator>::other accelerator_index;
+        typedef internal::modification<self>            modification;
+        // modification with at most N births and N deaths, that never allocates
+        template<unsigned int N> struct bounded_modification {
+            typedef internal::modification<self, rjmcmc::static_vector<value_type,N>, rjmcmc::static_vector<const_iterator,N> > type;
+        };
+    public:
+
+	// configuration constructors/destructors
+	flat_graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator()) : m_unary(0.), m_binary(0.), m_size(0), m_edges(0), m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator), m_index(accelerator), m_transaction(false)
+	{}
+	// copies do not share the transaction of the original, and their accelerator index tracks their own slots
+	flat_graph_configuration(const flat_graph_configuration& c) : m_unary(c.m_unary), m_binary(c.m_binary), m_size(c.m_size), m_edges(c.m_edges),
+            m_values(c.m_values), m_energies(c.m_energies), m_neighbours(c.m_neighbours), m_live(c.m_live), m_position(c.m_position), m_free(c.m_free), m_handles(c.m_handles),
+            m_unary_energy(c.m_unary_energy), m_binary_energy(c.m_binary_energy), m_accelerator(c.m_accelerator), m_index(c.m_accelerator), m_transaction(false)
+	{
+            reindex();
+	}
+	flat_graph_configuration& operator=(const flat_graph_configuration& c)
+	{
+            if(this==&c) return *this;
+            end_transaction();
+            m_unary  = c.m_unary;
+            m_binary = c.m_binary;
+            m_size   = c.m_size;
+            m_edges  = c.m_edges;
+            m_values     = c.m_values;
+            m_energies   = c.m_energies;
+            m_neighbours = c.m_neighbours;
+            m_live       = c.m_live;
+            m_position   = c.m_position;
+            m_free       = c.m_free;
+            m_handles    = c.m_handles;
+            m_unary_energy  = c.m_unary_energy;
+            m_binary_energy = c.m_binary_energy;
+            m_accelerator   = c.m_accelerator;
+            m_index = accelerator_index(m_accelerator);
+            reindex();
+            return *this;
+	}
+
+	// configuration accessors
+	inline double unary_energy () const { return m_unary;}
+	inline double binary_energy() const { return m_binary;}
+	inline double energy       () const {
+            return unary_energy()+binary_energy();
+	}
+
+	// energy functors accessors
+	inline const UnaryEnergy&  unary_energy_functor () const { return m_unary_energy; }
+	inline const BinaryEnergy& binary_energy_functor() const { return m_binary_energy; }
+	inline const Accelerator&  accelerator          () const { return m_accelerator; }
+
+	// values
+	inline size_t size() const { return m_size; }
+	inline bool empty() const { return m_size==0; }
+	inline const_iterator begin() const { return const_iterator(this,next(0)); }
+	inline const_iterator end  () const { return const_iterator(this,handle_type(m_live.size())); }
+	inline const value_type& value( const_iterator v ) const { return m_values[ *v ]; }
+	inline double energy( const_iterator v ) const { return m_energies[ *v ]; }
+	friend inline const_iterator object_at(const flat_graph_configuration& c, size_t i) { return const_iterator(&c,c.m_handles[i]); }
+
+	// interactions
+	inline size_t size_of_interactions   () const { return m_edges; }
+	inline const_edge_iterator interactions_begin() const { return const_edge_iterator(this,0); }
+	inline const_edge_iterator interactions_end  () const { return const_edge_iterator(this,handle_type(m_live.size())); }
+	inline double energy( const_edge_iterator e ) const { return m_neighbours[ e.m_slot ][ e.m_k ].m_energy; }
+
+	// evaluators
+
+	template <typename Modification> double delta_energy(const Modification &modif) const
+	{
+            return delta_birth(modif)+delta_death(modif);
+	}
+
+	// early rejection : returns delta_energy(modif) if it is not greater than bound, or any value greater than bound otherwise.
+	// with non-negative binary energies, the summation of the binary energies of the births stops as soon as it exceeds bound.
+	template <typename Modification> double delta_energy(const Modification &modif, double bound) const
+	{
+            using rjmcmc::is_non_negative;
+            if(!is_non_negative(m_binary_energy)) return delta_energy(modif);
+            typedef typename Modification::birth_type::const_iterator bci;
+            typedef typename Modification::death_type::const_iterator dci;
+            bci bbeg = modif.birth().begin();
+            bci bend = modif.birth().end();
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            double delta = delta_death(modif);
+            for(bci it=bbeg; it!=bend; ++it)
+                delta += rjmcmc::apply_visitor(m_unary_energy,*it);
+            if(delta>bound) return delta;
+            for(bci it=bbeg; it!=bend; ++it) {
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend) {
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
+                        if(delta>bound) return delta;
+                    }
+                for (bci it2=bbeg; it2 != it; ++it2) {
+                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+                    if(delta>bound) return delta;
+                }
+            }
+            return delta;
+	}
+
+	template <typename Modification> double delta_birth(const Modification &modif) const
+	{
+            double delta = 0;
+            typedef typename Modification::birth_type::const_iterator bci;
+            typedef typename Modification::death_type::const_iterator dci;
+            bci bbeg = modif.birth().begin();
+            bci bend = modif.birth().end();
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            for(bci it=bbeg; it!=bend; ++it) {
+                delta += rjmcmc::apply_visitor(m_unary_energy,*it);
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend)
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
+                for (bci it2=bbeg; it2 != it; ++it2)
+                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+            }
+            return delta;
+	}
+
+	template <typename Modification> double delta_death(const Modification &modif) const
+	{
+            double delta = 0;
+            typedef typename Modification::death_type::const_iterator dci;
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            for(dci it=dbeg; it!=dend; ++it) {
+                handle_type s = **it;
+                delta -= m_energies[s];
+                const neighbour_list& n = m_neighbours[s];
+                for(typename neighbour_list::const_iterator it2=n.begin(); it2!=n.end(); ++it2) {
+                    bool found = false;
+                    for(dci it3=dbeg; it3!=it && !found; ++it3)
+                        found = (**it3 == it2->m_slot);
+                    if (!found)
+                        delta -= it2->m_energy;
+                }
+            }
+            return delta;
+        }
+
+	// manipulators
+	void insert(const value_type& obj)
+	{
+            double e = rjmcmc::apply_visitor(m_unary_energy,obj);
+            m_unary += e;
+            bool appended = m_free.empty();
+            handle_type s = allocate(obj,e);
+            if(m_transaction) m_undo.push_back(undo_entry(s,appended,m_undo_edges.size()));
+            candidate_iterator c, cend;
+            for (boost::tie(c,cend)=m_index(*this,obj); c != cend; ++c) {
+                handle_type t = **c;
+                if ( t == s ) continue;
+                double b = rjmcmc::apply_visitor(m_binary_energy, obj, m_values[t] );
+                if ( b == 0 ) continue;
+                link(s,t,b);
+                m_binary += b;
+            }
+            attach(s);
+	}
+
+        template<typename F> inline void for_each(F f) const {
+            for (handle_type s=next(0); s<m_live.size(); s=next(s+1))
+                rjmcmc::apply_visitor(f,m_values[s]);
+        }
+
+	void remove( const_iterator v )
+	{
+            handle_type s = *v;
+            if(m_transaction) m_undo.push_back(undo_entry(s,m_values[s],m_energies[s],m_position[s],m_undo_edges.size()));
+            detach(s);
+            const neighbour_list& n = m_neighbours[s];
+            for(typename neighbour_list::const_iterator it=n.begin(); it!=n.end(); ++it) {
+                m_binary -= it->m_energy;
+                if(m_transaction) m_undo_edges.push_back(std::make_pair(it->m_slot,it->m_energy));
+            }
+            m_unary -= m_energies[s];
+            unlink(s);
+            release(s);
+	}
+
+	inline void clear()
+	{
+            m_values.clear(); m_energies.clear(); m_neighbours.clear(); m_live.clear(); m_position.clear(); m_free.clear(); m_handles.clear();
+            m_index.clear(); m_unary=m_binary=0; m_size=m_edges=0; end_transaction();
+	}
+
+	// checkpoint hooks : the objects in order, using the save_state/load_state hooks of value_type, the energy sums and the random access table.
+	// Reinserting the objects in the same order fills the slots in the same order, hence the same trajectory
+	// provided the slots were not fragmented by removals.
+	friend void save_state(std::ostream& os, const flat_graph_configuration& c)
+	{
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,boost::uint64_t(c.size()));
+            for(const_iterator it=c.begin(); it!=c.end(); ++it) save_state(os,c.value(it));
+            rjmcmc::write_binary(os,c.m_unary);
+            rjmcmc::write_binary(os,c.m_binary);
+            for(const_iterator it=c.begin(); it!=c.end(); ++it) rjmcmc::write_binary(os,boost::uint64_t(c.m_position[*it]));
+	}
+	friend void load_state(std::istream& is, flat_graph_configuration& c)
+	{
+            using rjmcmc::load_state;
+            boost::uint64_t n = 0;
+            rjmcmc::read_binary(is,n);
+            c.clear();
+            value_type v;
+            for(boost::uint64_t i=0; i<n && is; ++i) { load_state(is,v); c.insert(v); }
+            rjmcmc::read_binary(is,c.m_unary);
+            rjmcmc::read_binary(is,c.m_binary);
+            for(const_iterator it=c.begin(); it!=c.end() && is; ++it) {
+                boost::uint64_t p = 0;
+                rjmcmc::read_binary(is,p);
+                c.m_position[*it] = handle_type(p);
+            }
+            if(is) for(const_iterator it=c.begin(); it!=c.end(); ++it) c.m_handles[c.m_position[*it]] = *it;
+	}
+
+	// transactions : as in graph_configuration, the insertions and removals performed after begin_transaction() are recorded
+	// in an undo log that rollback() replays backwards, while commit() keeps the changes. Transactions do not nest, and clear()
+	// ends the current one. Slots are allocated and released in stack order, so that rollback() restores each removed object
+	// in its former slot and table position, and the slot map exactly as it was at begin_transaction().
+	inline bool in_transaction() const { return m_transaction; }
+	void begin_transaction()
+	{
+            end_transaction();
+            m_transaction = true;
+            m_undo_unary  = m_unary;
+            m_undo_binary = m_binary;
+	}
+	inline void commit() { end_transaction(); }
+	void rollback()
+	{
+            if(!m_transaction) return;
+            m_transaction = false;
+            for(size_t i=m_undo.size(); i-- > 0;) {
+                const undo_entry& u = m_undo[i];
+                handle_type s = u.m_slot;
+                if(!u.m_removed) {
+                    detach(s);
+                    unlink(s);
+                    release(s);
+                    if(u.m_appended) {
+                        assert(s+1==m_live.size() && m_free.back()==s);
+                        m_free.pop_back();
+                        m_values.pop_back(); m_energies.pop_back(); m_neighbours.pop_back(); m_live.pop_back(); m_position.pop_back();
+                    }
+                    continue;
+                }
+                assert(!m_free.empty() && m_free.back()==s);
+                handle_type r = allocate(u.m_value,u.m_energy);
+                assert(r==s); (void)r;
+                size_t end = (i+1<m_undo.size()) ? m_undo[i+1].m_edges : m_undo_edges.size();
+                for(size_t j=u.m_edges; j<end; ++j)
+                    link(s,m_undo_edges[j].first,m_undo_edges[j].second);
+                attach(s,u.m_position);
+            }
+            m_unary  = m_undo_unary;
+            m_binary = m_undo_binary;
+            end_transaction();
+	}
+
+	// rebuilds in c (with its own energy functors) the configuration as it was at begin_transaction(), leaving this configuration and its transaction unchanged
+	void transaction_origin(self& c) const
+	{
+            // net difference : slots inserted and still occupied, values of the objects present at begin_transaction() and removed since
+            std::set<handle_type> inserted;
+            std::vector<const value_type *> removed;
+            for(typename std::vector<undo_entry>::const_iterator u=m_undo.begin(); u!=m_undo.end(); ++u) {
+                if(!u->m_removed) inserted.insert(u->m_slot);
+                else if(!inserted.erase(u->m_slot)) removed.push_back(&u->m_value);
+            }
+            c.clear();
+            for (const_iterator it=begin(); it != end(); ++it)
+                if(!inserted.count(*it)) c.insert(value(it));
+            for(typename std::vector<const value_type *>::const_iterator it=removed.begin(); it!=removed.end(); ++it)
+                c.insert(**it);
+	}
+
+	// apply-then-evaluate : applies modif (within the current transaction, if any) and returns the resulting energy variation.
+	template <typename Modification> double apply(const Modification &modif)
+	{
+            double e = energy();
+            modif.apply(*this);
+            return energy()-e;
+	}
+
+	// audit
+	double audit_unary_energy() const
+	{
+            double e = 0.;
+            for (const_iterator i=begin(); i != end(); ++i)
+                e += rjmcmc::apply_visitor(m_unary_energy, value(i) );
+            return e;
+	}
+
+	double audit_binary_energy() const
+	{
+            double e = 0.;
+            for(const_edge_iterator it=interactions_begin(); it!=interactions_end(); ++it)
+                e += rjmcmc::apply_visitor(m_binary_energy, m_values[(*it).first], m_values[(*it).second] );
+            return e;
+	}
+
+	unsigned int audit_structure() const
+	{
+            unsigned int err = 0;
+            for (const_iterator i=begin(); i != end(); ++i)
+            {
+                const_iterator j = i;
+                for (++j; j != end(); ++j)
+                {
+                    bool computed = (0!= rjmcmc::apply_visitor(m_binary_energy,value(i), value(j)));
+                    if (computed != linked(*i,*j)) ++err;
+                }
+            }
+            return err;
+	}
+
+    private:
+        typedef typename accelerator_index::iterator candidate_iterator;
+
+        // first occupied slot from s, or the slot count
+        inline handle_type next(handle_type s) const
+        {
+            while(s<m_live.size() && !m_live[s]) ++s;
+            return s;
+        }
+
+        // the last released slot if any, or a new one
+        handle_type allocate(const value_type& obj, double e)
+        {
+            handle_type s;
+            if(m_free.empty()) {
+                s = handle_type(m_live.size());
+                m_values.push_back(obj); m_energies.push_back(e); m_neighbours.push_back(neighbour_list()); m_live.push_back(1); m_position.push_back(0);
+            } else {
+                s = m_free.back();
+                m_free.pop_back();
+                m_values[s] = obj; m_energies[s] = e; m_live[s] = 1;
+            }
+            ++m_size;
+            return s;
+        }
+        inline void release(handle_type s)
+        {
+            m_live[s] = 0;
+            m_free.push_back(s);
+            --m_size;
+        }
+
+        // registers a slot in the accelerator index and in the random access table, at position p
+        // (the slot at p, if any, being moved to the end : the inverse of detach)
+        inline void attach(handle_type s, size_t p = size_t(-1))
+        {
+            m_index.insert(m_values[s], const_iterator(this,s));
+            size_t n = m_handles.size();
+            m_handles.push_back(s);
+            m_position[s] = handle_type(n);
+            if(p<n) {
+                std::swap(m_handles[p],m_handles[n]);
+                m_position[m_handles[n]] = handle_type(n);
+                m_position[s] = handle_type(p);
+            }
+        }
+        // unregisters a slot, the last entry of the table taking its position
+        inline void detach(handle_type s)
+        {
+            m_index.remove(m_values[s], const_iterator(this,s));
+            handle_type p = m_position[s];
+            m_handles[p] = m_handles.back();
+            m_position[m_handles[p]] = p;
+            m_handles.pop_back();
+        }
+
+        inline void link(handle_type s, handle_type t, double e)
+        {
+            m_neighbours[s].push_back(neighbour(t,e));
+            m_neighbours[t].push_back(neighbour(s,e));
+            ++m_edges;
+        }
+        // removes the interactions of s, keeping the capacity of its neighbour list
+        void unlink(handle_type s)
+        {
+            neighbour_list& n = m_neighbours[s];
+            for(typename neighbour_list::const_iterator it=n.begin(); it!=n.end(); ++it) {
+                neighbour_list& m = m_neighbours[it->m_slot];
+                for(typename neighbour_list::iterator it2=m.begin(); it2!=m.end(); ++it2)
+                    if(it2->m_slot==s) { *it2 = m.back(); m.pop_back(); break; }
+            }
+            m_edges -= n.size();
+            n.clear();
+        }
+        bool linked(handle_type s, handle_type t) const
+        {
+            const neighbour_list& n = m_neighbours[s];
+            for(typename neighbour_list::const_iterator it=n.begin(); it!=n.end(); ++it)
+                if(it->m_slot==t) return true;
+            return false;
+        }
+
+	// the random access table is copied along with the slots
+	inline void reindex()
+	{
+            for (const_iterator it=begin(); it != end(); ++it)
+                m_index.insert(value(it), it);
+	}
+
+	// undo log entry : an inserted slot (appended or recycled), or a removed slot with its value, its unary energy, its table position
+	// and the range [m_edges,next entry's m_edges) of its interactions in m_undo_edges
+	struct undo_entry {
+            undo_entry(handle_type s, bool appended, size_t e) : m_slot(s), m_energy(0), m_position(0), m_edges(e), m_removed(false), m_appended(appended) {}
+            undo_entry(handle_type s, const value_type& v, double energy, size_t p, size_t e) : m_slot(s), m_value(v), m_energy(energy), m_position(p), m_edges(e), m_removed(true), m_appended(false) {}
+            handle_type m_slot;
+            value_type m_value;
+            double m_energy;
+            size_t m_position;
+            size_t m_edges;
+            bool m_removed;
+            bool m_appended;
+	};
+
+	// clears the log but keeps its capacity, so that a transaction per iteration does not allocate in the long run
+	inline void end_transaction()
+	{
+            m_transaction = false;
+            m_undo.clear();
+            m_undo_edges.clear();
+	}
+
+        double m_unary;
+        double m_binary;
+        size_t m_size;
+        size_t m_edges;
+        std::vector<value_type>     m_values;
+        std::vector<double>         m_energies;
+        std::vector<neighbour_list> m_neighbours;
+        std::vector<char>           m_live;
+        std::vector<handle_type>    m_position; // index of each occupied slot in m_handles
+        std::vector<handle_type>    m_free;
+        std::vector<handle_type>    m_handles;  // random access table of the occupied slots
+	UnaryEnergy	m_unary_energy;
+	BinaryEnergy	m_binary_energy;
+        Accelerator	m_accelerator;
+        accelerator_index m_index;
+	bool m_transaction;
+	double m_undo_unary;
+	double m_undo_binary;
+	std::vector<undo_entry> m_undo;
+	std::vector<std::pair<handle_type,double> > m_undo_edges;
+    };
+
+}; // namespace marked_point_process
+
+#endif // FLAT_GRAPH_CONFIGURATION_HPP
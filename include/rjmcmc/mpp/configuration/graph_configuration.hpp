@@ -37,9 +37,14 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef GRAPH_CONFIGURATION_HPP
 #define GRAPH_CONFIGURATION_HPP
 
+#include <set>
+#include <map>
 #include <boost/graph/adjacency_list.hpp>
 #include "configuration.hpp"
+#include "rjmcmc/util/static_vector.hpp"
 #include "rjmcmc/util/variant.hpp" // apply_visitor
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/rjmcmc/energy/energy.hpp" // is_non_negative
 
 
 namespace marked_point_process {
@@ -50,6 +55,9 @@ namespace marked_point_process {
     public:
 	typedef graph_configuration<T,UnaryEnergy, BinaryEnergy, Accelerator, OutEdgeList, VertexList> self;
         typedef T	value_type;
+        typedef UnaryEnergy	unary_energy_type;
+        typedef BinaryEnergy	binary_energy_type;
+        typedef Accelerator	accelerator_type;
     private:
 	class edge {
 	public:
@@ -63,13 +71,17 @@ namespace marked_point_process {
 
 	class node {
 	public:
-            node(const value_type& obj, double e) : m_value(obj), m_energy(e) { }
+            node() : m_energy(0), m_position(0) { } // required by the copy of the graph
+            node(const value_type& obj, double e) : m_value(obj), m_energy(e), m_position(0) { }
             inline const value_type& value() const { return m_value; }
             inline double energy() const { return m_energy; }
+            inline size_t position() const { return m_position; }
+            inline void position(size_t p) { m_position = p; }
 
 	private:
             value_type	m_value;
             double	m_energy;
+            size_t	m_position; // index of the vertex in the random access table
 	};
 	typedef boost::adjacency_list<OutEdgeList, VertexList, boost::undirectedS, node, edge> graph_type;
 	typedef typename graph_type::out_edge_iterator	out_edge_iterator;
@@ -81,12 +93,36 @@ namespace marked_point_process {
 	typedef	typename graph_type::vertex_iterator	const_iterator;
 	typedef typename graph_type::edge_iterator	edge_iterator;
 	typedef typename graph_type::edge_iterator	const_edge_iterator;
+        typedef typename Accelerator::template rebind<const_iterator>::other accelerator_index;
         typedef internal::modification<self>            modification;
+        // modification with at most N births and N deaths, that never allocates
+        template<unsigned int N> struct bounded_modification {
+            typedef internal::modification<self, rjmcmc::static_vector<value_type,N>, rjmcmc::static_vector<const_iterator,N> > type;
+        };
     public:
 
 	// configuration constructors/destructors
-	graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator()) : m_unary(0.), m_binary(0.), m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator)
+	graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator()) : m_unary(0.), m_binary(0.), m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator), m_index(accelerator), m_transaction(false)
 	{}
+	// copies do not share the transaction of the original, and their accelerator index tracks their own vertices
+	graph_configuration(const graph_configuration& c) : m_unary(c.m_unary), m_binary(c.m_binary), m_graph(c.m_graph), m_unary_energy(c.m_unary_energy), m_binary_energy(c.m_binary_energy), m_accelerator(c.m_accelerator), m_index(c.m_accelerator), m_transaction(false)
+	{
+            reindex();
+	}
+	graph_configuration& operator=(const graph_configuration& c)
+	{
+            if(this==&c) return *this;
+            end_transaction();
+            m_unary  = c.m_unary;
+            m_binary = c.m_binary;
+            m_graph  = c.m_graph;
+            m_unary_energy  = c.m_unary_energy;
+            m_binary_energy = c.m_binary_energy;
+            m_accelerator   = c.m_accelerator;
+            m_index = accelerator_index(m_accelerator);
+            reindex();
+            return *this;
+	}
 	~graph_configuration()
 	{}
 
@@ -97,6 +133,11 @@ namespace marked_point_process {
             return unary_energy()+binary_energy();
 	}
 
+	// energy functors accessors
+	inline const UnaryEnergy&  unary_energy_functor () const { return m_unary_energy; }
+	inline const BinaryEnergy& binary_energy_functor() const { return m_binary_energy; }
+	inline const Accelerator&  accelerator          () const { return m_accelerator; }
+
 	// values
 	inline size_t size() const { return num_vertices(m_graph); }
 	inline bool empty() const {	return (num_vertices(m_graph)==0); }
@@ -106,6 +147,8 @@ namespace marked_point_process {
         inline const_iterator end  () const { return vertices(m_graph).second; }
 	inline const value_type& value( const_iterator v ) const { return m_graph[ *v ].value(); }
 	inline double energy( const_iterator v ) const { return m_graph[ *v ].energy(); }
+	// random access in constant time, through a table of the vertices maintained by swapping with the last entry
+	friend inline const_iterator object_at(const graph_configuration& c, size_t i) { return c.m_handles[i]; }
 
 	// interactions
 	inline size_t size_of_interactions   () const { return num_edges(m_graph);    }
@@ -122,6 +165,37 @@ namespace marked_point_process {
             return delta_birth(modif)+delta_death(modif);
 	}
 
+	// early rejection : returns delta_energy(modif) if it is not greater than bound, or any value greater than bound otherwise.
+	// with non-negative binary energies, the summation of the binary energies of the births stops as soon as it exceeds bound.
+	template <typename Modification> double delta_energy(const Modification &modif, double bound) const
+	{
+            using rjmcmc::is_non_negative;
+            if(!is_non_negative(m_binary_energy)) return delta_energy(modif);
+            typedef typename Modification::birth_type::const_iterator bci;
+            typedef typename Modification::death_type::const_iterator dci;
+            bci bbeg = modif.birth().begin();
+            bci bend = modif.birth().end();
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            double delta = delta_death(modif);
+            for(bci it=bbeg; it!=bend; ++it)
+                delta += rjmcmc::apply_visitor(m_unary_energy,*it);
+            if(delta>bound) return delta;
+            for(bci it=bbeg; it!=bend; ++it) {
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend) {
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
+                        if(delta>bound) return delta;
+                    }
+                for (bci it2=bbeg; it2 != it; ++it2) {
+                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+                    if(delta>bound) return delta;
+                }
+            }
+            return delta;
+	}
+
 	template <typename Modification> double delta_birth(const Modification &modif) const
 	{
             double delta = 0;
@@ -133,11 +207,10 @@ namespace marked_point_process {
             dci dend = modif.death().end();
             for(bci it=bbeg; it!=bend; ++it) {
                 delta += rjmcmc::apply_visitor(m_unary_energy,*it);
-                const_iterator   it2, end2;
-                boost::tie(it2,end2)=m_accelerator(*this,*it);
-                for (; it2 != end2; ++it2)
-                    if (std::find(dbeg,dend,it2)==dend)
-                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(it2) );
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend)
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
                 for (bci it2=bbeg; it2 != it; ++it2)
                     delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
             }
@@ -172,16 +245,17 @@ namespace marked_point_process {
             node n(obj, rjmcmc::apply_visitor(m_unary_energy,obj));
             m_unary += n.energy();
             vertex_descriptor d = add_vertex(n, m_graph);
-            iterator   it, end;
-
-            for (boost::tie(it,end)=m_accelerator(*this,obj); it != end; ++it) {
-                if ( *it == d ) continue;
-                double e = rjmcmc::apply_visitor(m_binary_energy, obj, value(it) );
+            if(m_transaction) m_undo.push_back(undo_entry(d,last_vertex(),m_undo_edges.size()));
+            candidate_iterator c, cend;
+            for (boost::tie(c,cend)=m_index(*this,obj); c != cend; ++c) {
+                if ( **c == d ) continue;
+                double e = rjmcmc::apply_visitor(m_binary_energy, obj, value(*c) );
                 if (   e == 0 ) continue;
-                edge_descriptor_bool new_edge = add_edge(d, *it, m_graph );
+                edge_descriptor_bool new_edge = add_edge(d, **c, m_graph );
                 m_graph[ new_edge.first ].energy( e );
                 m_binary += e;
             }
+            attach(last_vertex());
 	}
 
         template<typename F>
@@ -209,15 +283,118 @@ namespace marked_point_process {
 
 	void remove( iterator v )
 	{
+            if(m_transaction) m_undo.push_back(undo_entry(*v,m_graph[*v],m_undo_edges.size()));
+            detach(v);
             out_edge_iterator it, end;
-            for(boost::tie(it,end) = out_edges( *v, m_graph ); it!=end; ++it)
+            for(boost::tie(it,end) = out_edges( *v, m_graph ); it!=end; ++it) {
                 m_binary -= m_graph[ *it ].energy();
+                if(m_transaction) m_undo_edges.push_back(std::make_pair(target(*it,m_graph),m_graph[ *it ].energy()));
+            }
             m_unary -= m_graph[*v].energy();
             clear_vertex ( *v , m_graph);
             remove_vertex( *v , m_graph);
 	}
 
-	inline void clear() { m_graph.clear(); m_unary=m_binary=0; }
+	inline void clear() { m_graph.clear(); m_index.clear(); m_handles.clear(); m_unary=m_binary=0; end_transaction(); }
+
+	// checkpoint hooks : the objects in order, using the save_state/load_state hooks of value_type, the energy sums and the random access table.
+	// Reinserting the objects in the same order rebuilds the same vertex and out-edge orders, hence the same trajectory.
+	friend void save_state(std::ostream& os, const graph_configuration& c)
+	{
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,boost::uint64_t(c.size()));
+            for(const_iterator it=c.begin(); it!=c.end(); ++it) save_state(os,c.value(it));
+            rjmcmc::write_binary(os,c.m_unary);
+            rjmcmc::write_binary(os,c.m_binary);
+            for(const_iterator it=c.begin(); it!=c.end(); ++it) rjmcmc::write_binary(os,boost::uint64_t(c.m_graph[*it].position()));
+	}
+	friend void load_state(std::istream& is, graph_configuration& c)
+	{
+            using rjmcmc::load_state;
+            boost::uint64_t n = 0;
+            rjmcmc::read_binary(is,n);
+            c.clear();
+            value_type v;
+            for(boost::uint64_t i=0; i<n && is; ++i) { load_state(is,v); c.insert(v); }
+            rjmcmc::read_binary(is,c.m_unary);
+            rjmcmc::read_binary(is,c.m_binary);
+            for(const_iterator it=c.begin(); it!=c.end() && is; ++it) {
+                boost::uint64_t p = 0;
+                rjmcmc::read_binary(is,p);
+                c.m_graph[*it].position(size_t(p));
+            }
+            if(is) c.rebuild_handles();
+	}
+
+	// transactions : the insertions and removals performed after begin_transaction() are recorded in an undo log,
+	// so that rollback() restores the values, interactions and energies as they were at begin_transaction()
+	// without copying the graph. commit() keeps the changes. Transactions do not nest, and clear() ends the current one.
+	// The vertices restored by rollback() are new vertices : iterators to vertices removed within the transaction remain invalid.
+	inline bool in_transaction() const { return m_transaction; }
+	void begin_transaction()
+	{
+            end_transaction();
+            m_transaction = true;
+            m_undo_unary  = m_unary;
+            m_undo_binary = m_binary;
+	}
+	inline void commit() { end_transaction(); }
+	void rollback()
+	{
+            if(!m_transaction) return;
+            m_transaction = false;
+            // undo the log in reverse order. A vertex restored from the log gets a new descriptor,
+            // m_remap maps the descriptor it had when it was removed to the new vertex (the latest mapping wins).
+            for(size_t i=m_undo.size(); i-- > 0;) {
+                const undo_entry& u = m_undo[i];
+                if(!u.m_removed) {
+                    const_iterator it = remap(u.m_vertex,u.m_it);
+                    vertex_descriptor d = *it;
+                    detach(it);
+                    clear_vertex ( d , m_graph);
+                    remove_vertex( d , m_graph);
+                    continue;
+                }
+                vertex_descriptor d = add_vertex(u.m_node, m_graph);
+                const_iterator it = last_vertex();
+                attach(it, u.m_node.position());
+                size_t end = (i+1<m_undo.size()) ? m_undo[i+1].m_edges : m_undo_edges.size();
+                for(size_t j=u.m_edges; j<end; ++j) {
+                    edge_descriptor_bool new_edge = add_edge(d, remap(m_undo_edges[j].first), m_graph );
+                    m_graph[ new_edge.first ].energy( m_undo_edges[j].second );
+                }
+                m_remap[u.m_vertex] = it;
+            }
+            m_unary  = m_undo_unary;
+            m_binary = m_undo_binary;
+            end_transaction();
+	}
+
+	// rebuilds in c (with its own energy functors) the configuration as it was at begin_transaction(), leaving this configuration and its transaction unchanged
+	void transaction_origin(self& c) const
+	{
+            // net difference : vertices inserted and still present, values of the vertices present at begin_transaction() and removed since
+            std::set<vertex_descriptor> inserted;
+            std::vector<const value_type *> removed;
+            for(typename std::vector<undo_entry>::const_iterator u=m_undo.begin(); u!=m_undo.end(); ++u) {
+                if(!u->m_removed) inserted.insert(u->m_vertex);
+                else if(!inserted.erase(u->m_vertex)) removed.push_back(&u->m_node.value());
+            }
+            c.clear();
+            for (const_iterator it=begin(); it != end(); ++it)
+                if(!inserted.count(*it)) c.insert(value(it));
+            for(typename std::vector<const value_type *>::const_iterator it=removed.begin(); it!=removed.end(); ++it)
+                c.insert(**it);
+	}
+
+	// apply-then-evaluate : applies modif (within the current transaction, if any) and returns the resulting energy variation.
+	// The binary energies are computed once by insert(), which may be cheaper than delta_energy(modif) followed by modif.apply(*this).
+	template <typename Modification> double apply(const Modification &modif)
+	{
+            double e = energy();
+            modif.apply(*this);
+            return energy()-e;
+	}
 
 	// audit
 	double audit_unary_energy() const
@@ -255,12 +432,96 @@ namespace marked_point_process {
 	}
 
     private:
+        typedef typename accelerator_index::iterator candidate_iterator;
+
+	// the vertex that has just been added (vertices are appended to the vertex list)
+	inline const_iterator last_vertex() const { const_iterator it = end(); return --it; }
+
+	// the random access table of a copy follows the positions stored in the copied vertices
+	inline void reindex()
+	{
+            for (const_iterator it=begin(); it != end(); ++it)
+                m_index.insert(value(it), it);
+            rebuild_handles();
+	}
+	inline void rebuild_handles()
+	{
+            m_handles.resize(size());
+            for (const_iterator it=begin(); it != end(); ++it)
+                m_handles[m_graph[*it].position()] = it;
+	}
+
+	// registers a new vertex in the accelerator index and in the random access table, at position p
+	// (the vertex at p, if any, being moved to the end : the inverse of detach)
+	inline void attach(const_iterator it, size_t p = size_t(-1))
+	{
+            m_index.insert(value(it), it);
+            size_t n = m_handles.size();
+            m_handles.push_back(it);
+            m_graph[*it].position(n);
+            if(p<n) {
+                std::swap(m_handles[p],m_handles[n]);
+                m_graph[*m_handles[n]].position(n);
+                m_graph[*it].position(p);
+            }
+	}
+	// unregisters a vertex, the last entry of the table taking its position
+	inline void detach(const_iterator it)
+	{
+            m_index.remove(value(it), it);
+            size_t p = m_graph[*it].position();
+            m_handles[p] = m_handles.back();
+            m_graph[*m_handles[p]].position(p);
+            m_handles.pop_back();
+	}
+
+	// undo log entry : an inserted vertex with its iterator, or a removed vertex with its node and the range [m_edges,next entry's m_edges) of its edges in m_undo_edges
+	struct undo_entry {
+            undo_entry(vertex_descriptor v, const_iterator it, size_t e) : m_vertex(v), m_it(it), m_edges(e), m_removed(false) {}
+            undo_entry(vertex_descriptor v, const node& n, size_t e) : m_vertex(v), m_node(n), m_edges(e), m_removed(true) {}
+            vertex_descriptor m_vertex;
+            const_iterator m_it;
+            node m_node;
+            size_t m_edges;
+            bool m_removed;
+	};
+
+	inline const_iterator remap(vertex_descriptor v, const_iterator it) const
+	{
+            typename remap_type::const_iterator r = m_remap.find(v);
+            return (r==m_remap.end()) ? it : r->second;
+	}
+	inline vertex_descriptor remap(vertex_descriptor v) const
+	{
+            typename remap_type::const_iterator r = m_remap.find(v);
+            return (r==m_remap.end()) ? v : *r->second;
+	}
+
+	// clears the undo log but keeps its capacity, so that a transaction per iteration does not allocate in the long run
+	// (only the remap filled by a rollback does)
+	inline void end_transaction()
+	{
+            m_transaction = false;
+            m_undo.clear();
+            m_undo_edges.clear();
+            m_remap.clear();
+	}
+
         double m_unary;
         double m_binary;
 	graph_type m_graph;
 	UnaryEnergy	m_unary_energy;
 	BinaryEnergy	m_binary_energy;
         Accelerator	m_accelerator;
+        accelerator_index m_index;
+	bool m_transaction;
+	double m_undo_unary;
+	double m_undo_binary;
+	std::vector<undo_entry> m_undo;
+	std::vector<std::pair<vertex_descriptor,double> > m_undo_edges;
+	typedef std::map<vertex_descriptor,const_iterator> remap_type;
+	remap_type m_remap;
+	std::vector<const_iterator> m_handles;
     };
 
 }; // namespace marked_point_process
@@ -0,0 +1,219 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef GRID_ACCELERATOR_HPP
+#define GRID_ACCELERATOR_HPP
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include "rjmcmc/geometry/geometry.hpp" // to_double
+
+namespace marked_point_process {
+
+    /// axis aligned bounding box of an object (default : its bbox() member, as provided by Rectangle_2)
+    template<typename T>
+    inline void bounding_box(const T& t, double b[4])
+    {
+        b[0] = geometry::to_double(t.bbox().min().x());
+        b[1] = geometry::to_double(t.bbox().min().y());
+        b[2] = geometry::to_double(t.bbox().max().x());
+        b[3] = geometry::to_double(t.bbox().max().y());
+    }
+
+    namespace internal {
+        template<typename Iterator> class grid_index;
+    }
+
+    /**
+     * Accelerator bucketing the objects of a configuration in a uniform grid of square cells covering a bounding box,
+     * the border cells extending to infinity. Each object is recorded in all the cells its bounding box overlaps,
+     * and a query only reports the objects whose bounding box overlaps the bounding box of the query object, enlarged by `margin`.
+     * It is thus exact as long as objects interact only if their bounding boxes are closer than `margin`
+     * (0 for overlap-based energies such as intersection_area_binary_energy), whatever their size.
+     * The cost of a query is proportional to the density of objects, when cells are about the size of the objects :
+     * `extent` is the maximum distance from the center of an object to its boundary, the cells being twice as large.
+     * Objects are required to be of a single type, with a bounding_box overload (by default their bbox() member).
+     */
+    class grid_accelerator
+    {
+    public:
+        template<typename Iterator> struct rebind { typedef internal::grid_index<Iterator> other; };
+
+        template<typename IsoRectangle>
+        grid_accelerator(const IsoRectangle& bbox, double extent, double margin = 0)
+            : m_x0(geometry::to_double(bbox.min().x())), m_y0(geometry::to_double(bbox.min().y()))
+            , m_size(extent>0 ? 2*extent : 1), m_margin(margin)
+        {
+            m_nx = 1+(unsigned int)(std::ceil((geometry::to_double(bbox.max().x())-m_x0)/m_size));
+            m_ny = 1+(unsigned int)(std::ceil((geometry::to_double(bbox.max().y())-m_y0)/m_size));
+        }
+
+        inline double size() const { return m_size; }
+        inline unsigned int cells() const { return m_nx*m_ny; }
+
+    protected:
+        double m_x0, m_y0, m_size, m_margin;
+        unsigned int m_nx, m_ny;
+    };
+
+    namespace internal {
+
+        template<typename Iterator>
+        class grid_index : private grid_accelerator
+        {
+            struct entry
+            {
+                entry(Iterator it, const double b[4]) : m_it(it) { std::copy(b,b+4,m_bbox); }
+                Iterator m_it;
+                double m_bbox[4];
+            };
+            typedef std::vector<entry> cell_type;
+
+        public:
+            // iterator over the candidates of a query. An object found in several cells is only reported in the cell
+            // that contains the lower corner of the intersection of its bounding box with the query box.
+            class iterator : public boost::iterator_facade<iterator, const Iterator, boost::forward_traversal_tag>
+            {
+            public:
+                iterator() : m_index(NULL), m_y(0), m_x(0), m_k(0) {}
+                iterator(const grid_index *index, const double b[4]) : m_index(index), m_k(0)
+                {
+                    std::copy(b,b+4,m_bbox);
+                    m_x0 = m_index->ix(b[0]); m_x1 = m_index->ix(b[2]);
+                    m_y0 = m_index->iy(b[1]); m_y1 = m_index->iy(b[3]);
+                    m_x = m_x0; m_y = m_y0;
+                    if(!found()) increment();
+                }
+                // past-the-end iterator of a query
+                iterator(const grid_index *index) : m_index(index), m_y(index->m_ny), m_x(0), m_k(0) {}
+
+            private:
+                friend class boost::iterator_core_access;
+
+                inline const cell_type& cell() const { return m_index->m_cells[m_x+m_index->m_nx*m_y]; }
+                inline const Iterator& dereference() const { return cell()[m_k].m_it; }
+                inline bool equal(const iterator& it) const { return m_y==it.m_y && m_x==it.m_x && m_k==it.m_k; }
+
+                // whether the current entry exists and is reported
+                bool found() const
+                {
+                    if(m_y>m_y1) return true; // end
+                    const cell_type& c = cell();
+                    if(m_k>=c.size()) return false;
+                    const double *b = c[m_k].m_bbox;
+                    if(b[0]>m_bbox[2] || b[2]<m_bbox[0] || b[1]>m_bbox[3] || b[3]<m_bbox[1]) return false;
+                    return m_index->ix((std::max)(b[0],m_bbox[0]))==m_x && m_index->iy((std::max)(b[1],m_bbox[1]))==m_y;
+                }
+
+                void increment()
+                {
+                    do {
+                        if(++m_k<cell().size()) continue;
+                        m_k = 0;
+                        if(++m_x>m_x1) { m_x = m_x0; if(++m_y>m_y1) { m_x = 0; m_y = m_index->m_ny; return; } }
+                    } while(!found());
+                }
+
+                const grid_index *m_index;
+                double m_bbox[4];
+                unsigned int m_x0, m_x1, m_y0, m_y1;
+                unsigned int m_y, m_x;
+                size_t m_k;
+            };
+
+            grid_index(const grid_accelerator& a) : grid_accelerator(a), m_cells(a.cells()) {}
+
+            template<typename C, typename T> std::pair<iterator,iterator> operator()(const C &, const T &t) const
+            {
+                double b[4];
+                bounding_box(t,b);
+                b[0] -= m_margin; b[1] -= m_margin; b[2] += m_margin; b[3] += m_margin;
+                return std::make_pair(iterator(this,b),iterator(this));
+            }
+
+            template<typename V> void insert(const V& v, Iterator it)
+            {
+                double b[4];
+                bounding_box(v,b);
+                unsigned int x0 = ix(b[0]), x1 = ix(b[2]), y1 = iy(b[3]);
+                for(unsigned int y=iy(b[1]); y<=y1; ++y)
+                    for(unsigned int x=x0; x<=x1; ++x)
+                        m_cells[x+m_nx*y].push_back(entry(it,b));
+            }
+
+            // the order of the remaining entries is preserved, so that it only depends on the order of the vertices
+            template<typename V> void remove(const V& v, Iterator it)
+            {
+                double b[4];
+                bounding_box(v,b);
+                unsigned int x0 = ix(b[0]), x1 = ix(b[2]), y1 = iy(b[3]);
+                for(unsigned int y=iy(b[1]); y<=y1; ++y)
+                    for(unsigned int x=x0; x<=x1; ++x)
+                    {
+                        cell_type& c = m_cells[x+m_nx*y];
+                        for(typename cell_type::iterator e=c.begin(); e!=c.end(); ++e)
+                            if(e->m_it==it) { c.erase(e); break; }
+                    }
+            }
+
+            // empties the cells but keeps their capacity
+            void clear()
+            {
+                for(typename std::vector<cell_type>::iterator c=m_cells.begin(); c!=m_cells.end(); ++c) c->clear();
+            }
+
+        private:
+            inline unsigned int index(double x, double x0, unsigned int n) const
+            {
+                double i = std::floor((x-x0)/m_size);
+                if(!(i>0)) return 0; // also catches NaNs
+                if(i>=n-1) return n-1;
+                return (unsigned int) i;
+            }
+            inline unsigned int ix(double x) const { return index(x,m_x0,m_nx); }
+            inline unsigned int iy(double y) const { return index(y,m_y0,m_ny); }
+
+            std::vector<cell_type> m_cells;
+        };
+
+    }; // namespace internal
+
+}; // namespace marked_point_process
+
+#endif // GRID_ACCELERATOR_HPP
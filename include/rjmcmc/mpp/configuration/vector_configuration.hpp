@@ -37,8 +37,12 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef VECTOR_CONFIGURATION_HPP
 #define VECTOR_CONFIGURATION_HPP
 
+#include <boost/tuple/tuple.hpp> // tie
 #include "configuration.hpp"
+#include "rjmcmc/util/static_vector.hpp"
 #include "rjmcmc/util/variant.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/rjmcmc/energy/energy.hpp" // is_non_negative
 
 namespace marked_point_process {
 
@@ -47,21 +51,60 @@ namespace marked_point_process {
     {
 	typedef	std::vector<T> container;
 	container	m_container;
+        double	m_unary;
+        double	m_binary;
 	UnaryEnergy	m_unary_energy;
 	BinaryEnergy	m_binary_energy;
 	Accelerator	m_accelerator;
     public:
         typedef typename container::const_iterator const_iterator;
         typedef typename container::iterator       iterator;
+        typedef typename Accelerator::template rebind<const_iterator>::other accelerator_index;
+    private:
+        typedef typename accelerator_index::iterator candidate_iterator;
+        accelerator_index m_index;
+    public:
         typedef T					value_type;
+        typedef UnaryEnergy	unary_energy_type;
+        typedef BinaryEnergy	binary_energy_type;
+        typedef Accelerator	accelerator_type;
 	typedef vector_configuration<T,UnaryEnergy, BinaryEnergy, Accelerator> self;
         typedef internal::modification<self>	        modification;
+        // modification with at most N births and N deaths, that never allocates
+        template<unsigned int N> struct bounded_modification {
+            typedef internal::modification<self, rjmcmc::static_vector<value_type,N>, rjmcmc::static_vector<const_iterator,N> > type;
+        };
 
 
         vector_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator())
-            : m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator)
+            : m_unary(0.), m_binary(0.), m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator), m_index(accelerator)
 	{}
+        // the accelerator index of a copy tracks its own objects
+        vector_configuration(const vector_configuration& c)
+            : m_container(c.m_container), m_unary(c.m_unary), m_binary(c.m_binary), m_unary_energy(c.m_unary_energy), m_binary_energy(c.m_binary_energy)
+            , m_accelerator(c.m_accelerator), m_index(c.m_accelerator)
+	{
+            reindex();
+	}
+        vector_configuration& operator=(const vector_configuration& c)
+        {
+            if(this==&c) return *this;
+            m_container     = c.m_container;
+            m_unary         = c.m_unary;
+            m_binary        = c.m_binary;
+            m_unary_energy  = c.m_unary_energy;
+            m_binary_energy = c.m_binary_energy;
+            m_accelerator   = c.m_accelerator;
+            m_index = accelerator_index(m_accelerator);
+            reindex();
+            return *this;
+        }
+
 
+	// energy functors accessors
+	inline const UnaryEnergy&  unary_energy_functor () const { return m_unary_energy; }
+	inline const BinaryEnergy& binary_energy_functor() const { return m_binary_energy; }
+	inline const Accelerator&  accelerator          () const { return m_accelerator; }
 
         // objects
         inline size_t size() const { return m_container.size(); }
@@ -71,29 +114,90 @@ namespace marked_point_process {
         inline const_iterator begin() const { return m_container.begin(); }
         inline const_iterator end  () const { return m_container.end  (); }
         inline const value_type& value( const_iterator v ) const { return *v; }
+        friend inline const_iterator object_at(const vector_configuration& c, size_t i) { return c.begin()+i; }
 
 
         // container
-	inline void clear() { m_container.clear(); }
+	inline void clear() { m_container.clear(); m_index.clear(); m_unary=m_binary=0; }
 
+        // the energy sums are updated with the energies of the inserted or removed object.
+        // the accelerator index tracks positions : it is rebuilt when the container grows, and updated for the object moved by a removal
         template<typename U>
         void insert(const U&u) {
+            bool grow = (m_container.size()==m_container.capacity());
             m_container.push_back(u);
+            const_iterator last = m_container.end()-1;
+            if(grow) reindex();
+            m_unary += rjmcmc::apply_visitor(m_unary_energy, *last);
+            candidate_iterator c, cend;
+            for (boost::tie(c,cend)=m_index(*this,*last); c != cend; ++c)
+                if (*c != last)
+                    m_binary += rjmcmc::apply_visitor(m_binary_energy, *last, value(*c) );
+            if(!grow) m_index.insert(*last, last);
 	}
         void remove( const_iterator  v ) {
-            std::swap(const_cast<value_type&>(*v),m_container.back());
+            const_iterator last = m_container.end()-1;
+            m_unary -= rjmcmc::apply_visitor(m_unary_energy, *v);
+            candidate_iterator c, cend;
+            for (boost::tie(c,cend)=m_index(*this,*v); c != cend; ++c)
+                if (*c != v)
+                    m_binary -= rjmcmc::apply_visitor(m_binary_energy, *v, value(*c) );
+            m_index.remove(*v, v);
+            if(v!=last) {
+                m_index.remove(*last, last);
+                std::swap(const_cast<value_type&>(*v),m_container.back());
+                m_index.insert(*v, v);
+            }
             m_container.pop_back();
 	}
 
+        // a removal moves the last object, so the objects are removed from the last position down
+        template<typename Iterator>
+        friend void remove_all(vector_configuration& c, Iterator first, Iterator last)
+        {
+            const_iterator bound = c.end();
+            for(Iterator k=first; k!=last; ++k) {
+                const_iterator v = c.begin();
+                for(Iterator it=first; it!=last; ++it)
+                    if(*it<bound && v<*it) v = *it;
+                c.remove(v);
+                bound = v;
+            }
+        }
+
         template<typename F> inline void for_each(F f)       { std::for_each(m_container.begin(),m_container.end(),f); }
         template<typename F> inline void for_each(F f) const { std::for_each(m_container.begin(),m_container.end(),f); }
 
+        // the objects, in order, using the save_state/load_state hooks of value_type, and the energy sums
+        friend void save_state(std::ostream& os, const vector_configuration& c)
+        {
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,boost::uint64_t(c.size()));
+            for(const_iterator it=c.begin(); it!=c.end(); ++it) save_state(os,*it);
+            rjmcmc::write_binary(os,c.m_unary);
+            rjmcmc::write_binary(os,c.m_binary);
+        }
+        friend void load_state(std::istream& is, vector_configuration& c)
+        {
+            using rjmcmc::load_state;
+            boost::uint64_t n = 0;
+            rjmcmc::read_binary(is,n);
+            c.clear();
+            value_type v;
+            for(boost::uint64_t i=0; i<n && is; ++i) { load_state(is,v); c.insert(v); }
+            rjmcmc::read_binary(is,c.m_unary);
+            rjmcmc::read_binary(is,c.m_binary);
+        }
+
         // energy
         inline double energy () const {
             return unary_energy()+binary_energy();
         }
+        inline double unary_energy () const { return m_unary; }
+        inline double binary_energy() const { return m_binary; }
 
-        double unary_energy() const
+        // audit energy, computed from scratch
+        double audit_unary_energy() const
         {
             double e = 0.;
             for (const_iterator it = m_container.begin(); it != m_container.end(); ++it)
@@ -101,7 +205,7 @@ namespace marked_point_process {
             return e;
         }
 
-        double binary_energy() const
+        double audit_binary_energy() const
         {
             double e = 0.;
             for (const_iterator i = m_container.begin(); i != m_container.end(); ++i)
@@ -109,6 +213,7 @@ namespace marked_point_process {
                     e += rjmcmc::apply_visitor(m_binary_energy, *i, *j );
             return e;
         }
+	inline unsigned int audit_structure() const { return 0; }
 
         // delta energy
         template <typename Modification> double delta_energy(const Modification &modif) const
@@ -116,6 +221,37 @@ namespace marked_point_process {
             return delta_birth(modif)+delta_death(modif);
         }
 
+        // early rejection : returns delta_energy(modif) if it is not greater than bound, or any value greater than bound otherwise.
+        // with non-negative binary energies, the summation of the binary energies of the births stops as soon as it exceeds bound.
+        template <typename Modification> double delta_energy(const Modification &modif, double bound) const
+        {
+            using rjmcmc::is_non_negative;
+            if(!is_non_negative(m_binary_energy)) return delta_energy(modif);
+            typedef typename Modification::birth_type::const_iterator bci;
+            typedef typename Modification::death_type::const_iterator dci;
+            bci bbeg = modif.birth().begin();
+            bci bend = modif.birth().end();
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            double delta = delta_death(modif);
+            for(bci it=bbeg; it!=bend; ++it)
+                delta += rjmcmc::apply_visitor(m_unary_energy,*it);
+            if(delta>bound) return delta;
+            for(bci it=bbeg; it!=bend; ++it) {
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend) {
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
+                        if(delta>bound) return delta;
+                    }
+                for (bci it2=it+1; it2 != bend; ++it2) {
+                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+                    if(delta>bound) return delta;
+                }
+            }
+            return delta;
+        }
+
         template <typename Modification> double delta_birth(const Modification &modif) const
         {
             double delta = 0;
@@ -127,9 +263,10 @@ namespace marked_point_process {
             dci dend = modif.death().end();
             for(bci it=bbeg; it!=bend; ++it) {
                 delta += rjmcmc::apply_visitor(m_unary_energy,*it);
-                for (const_iterator it2=m_container.begin(); it2 != m_container.end(); ++it2)
-                    if (std::find(dbeg,dend,it2)==dend)
-                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(it2) );
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,*it); c != cend; ++c)
+                    if (std::find(dbeg,dend,*c)==dend)
+                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(*c) );
                 for (bci it2=it+1; it2 != bend; ++it2)
                     delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
             }
@@ -144,17 +281,21 @@ namespace marked_point_process {
             dci dend = modif.death().end();
             for(dci it=dbeg; it!=dend; ++it) {
                 delta -= rjmcmc::apply_visitor(m_unary_energy, value(*it));
-                for (const_iterator it2=m_container.begin(); it2 != m_container.end(); ++it2)
-                    if(std::find(it,dend,it2)==dend)
-                        delta -= rjmcmc::apply_visitor(m_binary_energy, value(*it), *it2 );
+                candidate_iterator c, cend;
+                for (boost::tie(c,cend)=m_index(*this,value(*it)); c != cend; ++c)
+                    if(std::find(it,dend,*c)==dend)
+                        delta -= rjmcmc::apply_visitor(m_binary_energy, value(*it), value(*c) );
             }
             return delta;
         }
 
-        // audit energy
-	inline double audit_unary_energy () const { return unary_energy();}
-	inline double audit_binary_energy() const { return binary_energy();}
-	inline unsigned int audit_structure() const { return 0; }
+    private:
+        inline void reindex()
+        {
+            m_index.clear();
+            for (const_iterator it=m_container.begin(); it != m_container.end(); ++it)
+                m_index.insert(*it, it);
+        }
     };
 
 
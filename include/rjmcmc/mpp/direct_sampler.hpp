@@ -37,8 +37,13 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef DIRECT_SAMPLER_HPP
 #define DIRECT_SAMPLER_HPP
 
+#include "rjmcmc/util/checkpoint.hpp"
+
 namespace marked_point_process {
 
+    // number of objects of the whole process, which differs from c.size() for configurations restricted to a subdomain
+    template<typename Configuration> inline size_t process_size(const Configuration &c) { return c.size(); }
+
     // does not handle configurations with multiple object types yet
     // this would require some metaprogramming to handle a vector of (Density/ObjectSampler) pairs
     template<typename Density, typename ObjectSampler>
@@ -66,7 +71,7 @@ namespace marked_point_process {
         template<typename Configuration, typename Modification>
         double pdf_ratio(const Configuration &c, const Modification &m) const
         {
-            size_t n0 = c.size();
+            size_t n0 = process_size(c);
             size_t n1 = n0+m.birth().size()-m.death().size();
             double ratio = m_density.pdf_ratio(n0,n1);
             for(typename Modification::birth_type::const_iterator b = m.birth().begin(); b!=m.birth().end(); ++b)
@@ -90,6 +95,17 @@ namespace marked_point_process {
         inline int kernel_id() const { return 0; }
         inline bool accepted() const { return true; }
         enum { kernel_size = 1 };
+
+        friend void save_state(std::ostream& os, const direct_sampler& s) {
+            using rjmcmc::save_state;
+            save_state(os,s.m_density);
+            save_state(os,s.m_object_sampler);
+        }
+        friend void load_state(std::istream& is, direct_sampler& s) {
+            using rjmcmc::load_state;
+            load_state(is,s.m_density);
+            load_state(is,s.m_object_sampler);
+        }
     private:
         Density  m_density;
         ObjectSampler m_object_sampler;
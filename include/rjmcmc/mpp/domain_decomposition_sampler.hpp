@@ -0,0 +1,356 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef DOMAIN_DECOMPOSITION_SAMPLER_HPP
+#define DOMAIN_DECOMPOSITION_SAMPLER_HPP
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/thread/thread.hpp>
+#include "rjmcmc/geometry/geometry.hpp" // to_double
+#include "rjmcmc/rjmcmc/sampler/sampler.hpp" // sampler_base
+#include "rjmcmc/util/random.hpp" // split_stream
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+#include "rjmcmc/util/checkpoint.hpp"
+#include "configuration/graph_configuration.hpp"
+#include "direct_sampler.hpp" // process_size
+
+namespace marked_point_process {
+
+    namespace internal {
+
+        // regular grid of square cells covering a bounding box, shifted by an offset in [0,size)^2
+        // objects are assigned to the cell of their center, the border cells extending to infinity
+        class cell_grid
+        {
+        public:
+            cell_grid(double x0, double y0, double x1, double y1, double size)
+                : m_x0(x0), m_y0(y0), m_size(size), m_dx(0), m_dy(0)
+                , m_nx(1+(unsigned int)(std::ceil((x1-x0)/size)))
+                , m_ny(1+(unsigned int)(std::ceil((y1-y0)/size)))
+            {}
+
+            inline void offset(double dx, double dy) { m_dx = dx; m_dy = dy; }
+            inline double size() const { return m_size; }
+            inline unsigned int cells() const { return m_nx*m_ny; }
+            // cells of the same colour are never adjacent, not even by a corner
+            inline unsigned int colour(unsigned int i) const { return ((i%m_nx)&1) + 2*((i/m_nx)&1); }
+
+            template<typename T> unsigned int cell(const T& t) const
+            {
+                return index(geometry::to_double(t.center().x()),m_x0-m_dx,m_nx)
+                        + m_nx*index(geometry::to_double(t.center().y()),m_y0-m_dy,m_ny);
+            }
+
+            // the (up to 8) cells surrounding the cell i
+            void neighbours(unsigned int i, std::vector<unsigned int>& n) const
+            {
+                n.clear();
+                int x = i%m_nx, y = i/m_nx;
+                for(int v=y-1; v<=y+1; ++v)
+                    for(int u=x-1; u<=x+1; ++u)
+                        if((u!=x || v!=y) && u>=0 && v>=0 && u<int(m_nx) && v<int(m_ny))
+                            n.push_back(u+m_nx*v);
+            }
+
+        private:
+            inline unsigned int index(double x, double x0, unsigned int n) const
+            {
+                double i = std::floor((x-x0)/m_size);
+                if(!(i>0)) return 0; // also catches NaNs
+                if(i>=n-1) return n-1;
+                return (unsigned int) i;
+            }
+
+            double m_x0, m_y0, m_size, m_dx, m_dy;
+            unsigned int m_nx, m_ny;
+        };
+
+        // unary energy of an object of a cell : its own unary energy plus its interactions with the frozen objects around the cell
+        template<typename Configuration>
+        class halo_unary_energy
+        {
+        public:
+            typedef double result_type;
+            typedef typename Configuration::value_type value_type;
+            halo_unary_energy(const Configuration& c, const std::vector<value_type>& halo) : m_c(&c), m_halo(&halo) {}
+
+            template<typename T> result_type operator()(const T &t) const
+            {
+                double e = rjmcmc::apply_visitor(m_c->unary_energy_functor(),t);
+                typedef typename std::vector<value_type>::const_iterator iterator;
+                for(iterator h=m_halo->begin(); h!=m_halo->end(); ++h)
+                    e += rjmcmc::apply_visitor(m_c->binary_energy_functor(),t,*h);
+                return e;
+            }
+
+        private:
+            const Configuration *m_c;
+            const std::vector<value_type> *m_halo;
+        };
+
+        // configuration of the objects of a single cell, the rest of the configuration being frozen
+        template<typename Configuration>
+        class cell_configuration : public graph_configuration<
+                typename Configuration::value_type,
+                halo_unary_energy<Configuration>,
+                typename Configuration::binary_energy_type >
+        {
+            typedef graph_configuration<
+                    typename Configuration::value_type,
+                    halo_unary_energy<Configuration>,
+                    typename Configuration::binary_energy_type > base;
+        public:
+            typedef typename Configuration::value_type value_type;
+            cell_configuration(const Configuration& c, const std::vector<value_type>& halo,
+                               const cell_grid& grid, unsigned int cell, size_t outside)
+                : base(halo_unary_energy<Configuration>(c,halo),c.binary_energy_functor())
+                , m_grid(&grid), m_cell(cell), m_outside(outside)
+            {}
+
+            // births outside the cell are rejected through an infinite energy
+            template <typename Modification> double delta_energy(const Modification &modif) const
+            {
+                typedef typename Modification::birth_type::const_iterator bci;
+                for(bci it=modif.birth().begin(); it!=modif.birth().end(); ++it)
+                    if(m_grid->cell(*it)!=m_cell) return std::numeric_limits<double>::infinity();
+                return base::delta_energy(modif);
+            }
+
+            template <typename Modification> double delta_energy(const Modification &modif, double bound) const
+            {
+                typedef typename Modification::birth_type::const_iterator bci;
+                for(bci it=modif.birth().begin(); it!=modif.birth().end(); ++it)
+                    if(m_grid->cell(*it)!=m_cell) return std::numeric_limits<double>::infinity();
+                return base::delta_energy(modif,bound);
+            }
+
+            // number of objects outside the cell
+            inline size_t outside_size() const { return m_outside; }
+
+        private:
+            const cell_grid *m_grid;
+            unsigned int m_cell;
+            size_t m_outside;
+        };
+
+        // the reference process sees the whole configuration, not only the cell
+        template<typename Configuration>
+        inline size_t process_size(const cell_configuration<Configuration> &c) { return c.size()+c.outside_size(); }
+
+        // sampling of one cell during a phase of a sweep
+        template<typename Engine, typename Configuration>
+        struct cell_task
+        {
+            typedef typename Configuration::iterator iterator;
+            typedef typename Configuration::value_type value_type;
+            cell_task(unsigned int c, const Engine& e) : cell(c), engine(e), config(NULL), proposed(0), accepted(0), delta(0) {}
+            ~cell_task() { delete config; }
+
+            unsigned int cell;
+            Engine engine;
+            std::vector<value_type> halo;
+            cell_configuration<Configuration> *config;
+            unsigned int proposed, accepted;
+            double delta;
+        };
+
+    }; // namespace internal
+
+    /**
+     * \ingroup GroupSampler
+     *
+     * Parallel sampler based on a spatial domain decomposition, modeling the Sampler concept : one call performs a sweep.
+     * The bounding box is partitioned in square cells, coloured as a 2x2 checkerboard. Each colour is processed in turn,
+     * the cells of this colour being sampled concurrently by copies of the wrapped sampler, each with its own engine
+     * (split at the worker_stream level), while the objects of the other cells are frozen. The grid offset is redrawn
+     * at each sweep so that objects eventually cross the cell borders. Proposals are required to keep their object centers in their cell.
+     *
+     * This is exact as long as objects whose centers are in non-adjacent cells never interact, i.e. the cell size
+     * must be larger than twice the maximum object extent from its center : `extent` is this maximum extent,
+     * and a std::invalid_argument is thrown if `cell_size` is not larger than `2*extent`. Configurations must expose their energy
+     * functors (as graph_configuration does) and hold a single object type with a center() accessor.
+     */
+    //[domain_decomposition_sampler_signature
+    template<typename Sampler>
+    class domain_decomposition_sampler : public rjmcmc::sampler_base
+    {
+    public:
+        template<typename IsoRectangle>
+        domain_decomposition_sampler(const Sampler& sampler, const IsoRectangle& bbox, double cell_size, double extent,
+                                     unsigned int steps, unsigned int threads=0)
+    //]
+            : m_grid(geometry::to_double(bbox.min().x()),geometry::to_double(bbox.min().y()),
+                     geometry::to_double(bbox.max().x()),geometry::to_double(bbox.max().y()),cell_size)
+            , m_steps(steps), m_name("sweep")
+        {
+            if(!(cell_size>2*extent))
+                throw std::invalid_argument("domain_decomposition_sampler : the cell size must be larger than twice the maximum object extent");
+            if(!threads) threads = boost::thread::hardware_concurrency();
+            if(!threads) threads = 1;
+            m_samplers.assign(threads,sampler);
+            m_temperature = m_delta = m_acceptance_probability = 0;
+            m_green_ratio = m_kernel_ratio = m_ref_pdf_ratio = 1;
+            m_accepted = m_early_rejected = false;
+        }
+
+        template<typename Engine, typename Configuration>
+        void operator()(Engine& e, Configuration &c, double temp)
+        {
+            m_temperature = temp;
+            m_delta = 0;
+            unsigned int proposed = 0, accepted = 0;
+            boost::uniform_real<> offset(0,m_grid.size());
+            double dx = offset(e);
+            m_grid.offset(dx,offset(e));
+            for(unsigned int colour=0; colour<4; ++colour)
+                phase(e,c,temp,colour,proposed,accepted);
+            m_accepted = (accepted>0);
+            m_acceptance_probability = proposed ? double(accepted)/proposed : 0;
+        }
+
+        inline const std::string& kernel_name(unsigned int) const { return m_name; }
+        inline unsigned int kernel_id  () const { return 0; }
+        inline unsigned int kernel_size() const { return 1; }
+
+        // the grid offset and the cell engines are redrawn from the engine at each sweep
+        friend void save_state(std::ostream& os, const domain_decomposition_sampler& s)
+        {
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,boost::uint32_t(s.m_samplers.size()));
+            for(typename std::vector<Sampler>::const_iterator it=s.m_samplers.begin(); it!=s.m_samplers.end(); ++it)
+                save_state(os,*it);
+        }
+        friend void load_state(std::istream& is, domain_decomposition_sampler& s)
+        {
+            using rjmcmc::load_state;
+            boost::uint32_t n = 0;
+            rjmcmc::read_binary(is,n);
+            if(n!=s.m_samplers.size()) { is.setstate(std::ios::failbit); return; }
+            for(typename std::vector<Sampler>::iterator it=s.m_samplers.begin(); it!=s.m_samplers.end(); ++it)
+                load_state(is,*it);
+        }
+
+    private:
+        template<typename Engine, typename Configuration>
+        void phase(Engine& e, Configuration &c, double temp, unsigned int colour, unsigned int& proposed, unsigned int& accepted)
+        {
+            typedef internal::cell_task<Engine,Configuration> task;
+            typedef typename Configuration::iterator iterator;
+            std::vector< std::vector<iterator> > objects(m_grid.cells());
+            for(iterator it=c.begin(); it!=c.end(); ++it)
+                objects[m_grid.cell(c.value(it))].push_back(it);
+
+            // engines are split in cell order, and cells are dealt round-robin to the threads : a run is reproducible for a given number of threads
+            boost::ptr_vector<task> tasks;
+            for(unsigned int i=0; i<m_grid.cells(); ++i)
+                if(m_grid.colour(i)==colour)
+                    tasks.push_back(new task(i,rjmcmc::split_stream(e,rjmcmc::worker_stream)));
+
+            unsigned int threads = m_samplers.size();
+            if(threads>tasks.size()) threads = tasks.size();
+            if(threads>1)
+            {
+                boost::thread_group group;
+                for(unsigned int t=0; t<threads; ++t)
+                    group.create_thread(boost::bind(&domain_decomposition_sampler::template work<Engine,Configuration>,
+                                                    this,boost::cref(c),boost::cref(objects),boost::ref(tasks),t,threads,temp));
+                group.join_all();
+            }
+            else
+                work<Engine,Configuration>(c,objects,tasks,0,1,temp);
+
+            // write back the modified cells
+            for(typename boost::ptr_vector<task>::iterator t=tasks.begin(); t!=tasks.end(); ++t)
+            {
+                proposed += t->proposed;
+                accepted += t->accepted;
+                if(!t->accepted) continue;
+                m_delta += t->delta;
+                const std::vector<iterator>& cell = objects[t->cell];
+                for(typename std::vector<iterator>::const_iterator it=cell.begin(); it!=cell.end(); ++it)
+                    c.remove(*it);
+                for(typename internal::cell_configuration<Configuration>::const_iterator it=t->config->begin(); it!=t->config->end(); ++it)
+                    c.insert(t->config->value(it));
+            }
+        }
+
+        // thread body : samples the cells t, t+threads, t+2*threads...
+        template<typename Engine, typename Configuration>
+        void work(const Configuration& c, const std::vector< std::vector<typename Configuration::iterator> >& objects,
+                  boost::ptr_vector< internal::cell_task<Engine,Configuration> >& tasks, unsigned int t, unsigned int threads, double temp)
+        {
+            typedef typename Configuration::iterator iterator;
+            Sampler& sampler = m_samplers[t];
+            std::vector<unsigned int> neighbours;
+            for(unsigned int k=t; k<tasks.size(); k+=threads)
+            {
+                internal::cell_task<Engine,Configuration>& task = tasks[k];
+                const std::vector<iterator>& cell = objects[task.cell];
+                m_grid.neighbours(task.cell,neighbours);
+                for(std::vector<unsigned int>::const_iterator n=neighbours.begin(); n!=neighbours.end(); ++n)
+                    for(typename std::vector<iterator>::const_iterator it=objects[*n].begin(); it!=objects[*n].end(); ++it)
+                        task.halo.push_back(c.value(*it));
+                task.config = new internal::cell_configuration<Configuration>(c,task.halo,m_grid,task.cell,c.size()-cell.size());
+                for(typename std::vector<iterator>::const_iterator it=cell.begin(); it!=cell.end(); ++it)
+                    task.config->insert(c.value(*it));
+                double energy = task.config->energy();
+                for(unsigned int i=0; i<m_steps; ++i)
+                {
+                    sampler(task.engine,*task.config,temp);
+                    ++task.proposed;
+                    if(sampler.accepted()) ++task.accepted;
+                }
+                task.delta = task.config->energy()-energy;
+            }
+        }
+
+        internal::cell_grid  m_grid;
+        unsigned int         m_steps;
+        std::vector<Sampler> m_samplers;
+        std::string          m_name;
+    };
+
+}; // namespace marked_point_process
+
+#endif // DOMAIN_DECOMPOSITION_SAMPLER_HPP
@@ -58,6 +58,7 @@ public:
         return geometry::do_intersect(t, u);
     }
 
+    friend inline bool is_non_negative(const intersection_area_binary_energy&) { return true; }
 };
 
 #endif /*INTERSECTION_AREA_BINARY_ENERGY_HPP*/
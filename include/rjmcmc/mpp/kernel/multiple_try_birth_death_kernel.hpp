@@ -0,0 +1,184 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef MPP_MULTIPLE_TRY_BIRTH_DEATH_KERNEL_HPP
+#define MPP_MULTIPLE_TRY_BIRTH_DEATH_KERNEL_HPP
+
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <boost/random/uniform_real.hpp>
+#include <boost/random/uniform_smallint.hpp>
+#include "rjmcmc/util/variant.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/geometry/coordinates/coordinates.hpp"
+#include "rjmcmc/mpp/configuration/configuration.hpp" // object_at
+
+namespace marked_point_process {
+
+    /// unary energies of the objects [first,last) : energies may overload it to evaluate a whole batch at once
+    template<typename UnaryEnergy, typename T>
+    inline void unary_energies(const UnaryEnergy& energy, const T *first, const T *last, double *out)
+    {
+        for(; first!=last; ++first, ++out) *out = rjmcmc::apply_visitor(energy,*first);
+    }
+
+    /**
+     * Multiple-try birth and death kernel : a birth draws `tries` candidate objects from the birth,
+     * evaluates their unary energies in a single batch and selects one of them with a probability proportional
+     * to exp(-energy/temperature). The death of an object draws `tries`-1 auxiliary candidates to compute the
+     * reverse selection probability, so that the Green ratio of both moves is exact.
+     * As in uniform_view, the reverse birth density of a removed object is evaluated on one of its equivalent
+     * coordinate representations, drawn at random. With a single try, it proposes the same moves as
+     * uniform_birth_death_kernel, drawing the same random numbers.
+     */
+    //[multiple_try_birth_death_kernel_signature
+    template<typename Birth, unsigned int N=8>
+    class multiple_try_birth_death_kernel
+    //]
+    {
+        typedef typename Birth::value_type object_type;
+        typedef typename coordinates_iterator<object_type>::type iterator;
+        enum { dimension = Birth::dimension };
+
+        Birth m_birth;
+        unsigned int m_tries;
+        double m_temperature;
+        double m_p, m_p01, m_p10;
+        mutable unsigned int m_kernel_id;
+        mutable boost::uniform_real<> m_rand;
+        std::string m_name[2];
+
+    public:
+        enum { size = 2 };
+        enum { max_modification_size = 1 };
+        enum { delayed_rejection = 0 };
+        inline unsigned int kernel_id() const { return m_kernel_id; }
+        inline const std::string& name(unsigned int i) const { return m_name[i]; }
+        inline void name(unsigned int i, const std::string& s) { m_name[i]=s; }
+
+        /// tries is clamped to [1,N], q is the probability of the birth branch
+        multiple_try_birth_death_kernel(const Birth& b, unsigned int tries, double temperature=1., double p=1., double q=0.5) :
+                m_birth(b), m_tries((std::max)(1u,(std::min)(tries,N))), m_temperature(temperature),
+                m_p(p), m_p01(p*q), m_p10(p*(1.-q)), m_kernel_id(0), m_rand(0,1)
+        {
+            m_name[0]="birth";
+            m_name[1]="death";
+        }
+
+        inline double probability() const { return m_p; }
+        inline void probability(double p) {
+            double q = (m_p01+m_p10>0) ? m_p01/(m_p01+m_p10) : 0.5;
+            m_p = p; m_p01 = p*q; m_p10 = p*(1.-q);
+        }
+        inline unsigned int tries() const { return m_tries; }
+        inline double temperature() const { return m_temperature; }
+
+        friend void save_state(std::ostream& os, const multiple_try_birth_death_kernel& k) {
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,k.m_p); rjmcmc::write_binary(os,k.m_p01); rjmcmc::write_binary(os,k.m_p10);
+            save_state(os,k.m_birth);
+        }
+        friend void load_state(std::istream& is, multiple_try_birth_death_kernel& k) {
+            using rjmcmc::load_state;
+            rjmcmc::read_binary(is,k.m_p); rjmcmc::read_binary(is,k.m_p01); rjmcmc::read_binary(is,k.m_p10);
+            load_state(is,k.m_birth);
+        }
+
+        // prerequisite : p is uniform between 0 and probability()=m_p
+        template<typename Engine, typename Configuration, typename Modification>
+        double operator()(Engine& e, double p, Configuration& c, Modification& modif) const
+        {
+            modif.birth().clear();
+            modif.death().clear();
+            object_type candidates[N];
+            double phi[N], weights[N];
+
+            if(p<m_p01) { // birth
+                m_kernel_id = 0;
+                for(unsigned int i=0; i<m_tries; ++i)
+                    if((phi[i] = m_birth(e,candidates[i]))==0) return 0;
+                double w = weigh(c,candidates,0,weights);
+                unsigned int j = 0;
+                if(m_tries>1) {
+                    double x = w*m_rand(e);
+                    while(j+1<m_tries && x>=weights[j]) x -= weights[j++];
+                }
+                modif.birth().push_back(candidates[j]);
+                double n = c.size()+1;
+                return (m_p10/n)/(m_p01*phi[j]) * w/(m_tries*weights[j]);
+            } else { // death
+                m_kernel_id = 1;
+                unsigned int n = c.size();
+                if(n==0) return 0;
+                boost::uniform_smallint<> die(0,n-1);
+                typename Configuration::const_iterator it = object_at(c, die(e));
+                modif.death().push_back(it);
+                const object_type& t = c.value(it);
+                iterator coord_it = coordinates_begin(t,e); // random representation, as in uniform_view
+                double phi0 = m_birth.variate().pdf(coord_it);
+                if(phi0==0) return 0;
+                for(unsigned int i=1; i<m_tries; ++i)
+                    if(m_birth(e,candidates[i])==0) return 0;
+                double e0 = rjmcmc::apply_visitor(c.unary_energy_functor(),t);
+                double w = weigh(c,candidates,&e0,weights);
+                return (m_p01*phi0)/(m_p10/n) * (m_tries*weights[0])/w;
+            }
+        }
+
+    private:
+        // selection weights of the candidates (the first one being replaced by the energy e0 if provided), returns their sum
+        template<typename Configuration>
+        double weigh(const Configuration& c, const object_type *candidates, const double *e0, double *weights) const
+        {
+            double energies[N];
+            if(e0) {
+                energies[0] = *e0;
+                unary_energies(c.unary_energy_functor(),candidates+1,candidates+m_tries,energies+1);
+            } else {
+                unary_energies(c.unary_energy_functor(),candidates,candidates+m_tries,energies);
+            }
+            double emin = *std::min_element(energies,energies+m_tries);
+            double w = 0;
+            for(unsigned int i=0; i<m_tries; ++i) w += (weights[i] = std::exp((emin-energies[i])/m_temperature));
+            return w;
+        }
+    };
+
+}; // namespace marked_point_process
+
+#endif // MPP_MULTIPLE_TRY_BIRTH_DEATH_KERNEL_HPP
@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include "rjmcmc/rjmcmc/kernel/transform.hpp"
 #include "rjmcmc/rjmcmc/kernel/variate.hpp"
 #include "rjmcmc/geometry/coordinates/coordinates.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace marked_point_process {
     
@@ -85,6 +86,9 @@ namespace marked_point_process {
             iterator val(coordinates_begin(t));
             return m_variate.pdf(val);
         }
+
+        friend void save_state(std::ostream& os, const object_birth& b) { using rjmcmc::save_state; save_state(os,b.m_variate); }
+        friend void load_state(std::istream& is, object_birth& b) { using rjmcmc::load_state; load_state(is,b.m_variate); }
     private:
         variate_type m_variate;
     };
@@ -133,6 +137,10 @@ namespace marked_point_process {
     public:
         uniform_birth(const T& a, const T& b, V v = V()) : base_type(get_variate(a,b,v)) {}
 
+        // the default hooks would otherwise be preferred to the ones of the base class
+        friend void save_state(std::ostream& os, const uniform_birth& b) { save_state(os,static_cast<const base_type&>(b)); }
+        friend void load_state(std::istream& is, uniform_birth& b) { load_state(is,static_cast<base_type&>(b)); }
+
     };
 
 
@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <boost/random/uniform_smallint.hpp>
 
 #include "rjmcmc/geometry/coordinates/coordinates.hpp"
+#include "rjmcmc/mpp/configuration/configuration.hpp" // object_at
 
 namespace marked_point_process {
     
@@ -51,6 +52,7 @@ namespace marked_point_process {
     public:
         typedef T object_type;
         enum { dimension =  coordinates_iterator<T>::dimension };
+        enum { max_size = N }; // maximum number of objects selected by the view
 
         template<typename Engine, typename Configuration, typename Modification, typename OutputIterator>
         inline double operator()(Engine& e, Configuration const& c, Modification& m, OutputIterator out) const
@@ -67,8 +69,7 @@ namespace marked_point_process {
                 d[i]=die(e);
                 for(unsigned int j=0;j<i;++j) if(d[j]<=d[i]) ++d[i]; // skip already selected indices
 
-                typename Configuration::const_iterator it = c.begin();
-                std::advance(it, d[i]);
+                typename Configuration::const_iterator it = object_at(c, d[i]);
                 m.death().push_back(it);
                 const T& t = c.value(it);
                 iterator coord_it  = coordinates_begin(t,e);
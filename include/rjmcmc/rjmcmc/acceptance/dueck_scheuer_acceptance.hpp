@@ -37,6 +37,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef DUECK_SCHEUER_ACCEPTANCE_HPP
 #define DUECK_SCHEUER_ACCEPTANCE_HPP
 
+#include <cmath>
+
 namespace rjmcmc
 {
     /**
@@ -65,6 +67,12 @@ namespace rjmcmc
             // return (E<=T(log(R)-log(alpha)) ? 1 : 0; with alpha = exp(-1)
             return (delta <= temperature*(log(green_ratio)+1)) ? 1. : 0.;
         }
+
+        /// inverse of the acceptance rule : the modification is rejected by the uniform variate u if delta is greater than this bound
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            return temperature*(log(green_ratio)+1);
+        }
     };
 
 } // namespace rjmcmc
@@ -37,6 +37,9 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef FRANZ_HOFFMANN_ACCEPTANCE_HPP
 #define FRANZ_HOFFMANN_ACCEPTANCE_HPP
 
+#include <cmath>
+#include <limits>
+
 namespace rjmcmc
 {
     /**
@@ -61,7 +64,7 @@ namespace rjmcmc
 
     public:
         franz_hoffmann_acceptance(double q)
-            , m_q(q)
+            : m_q(q)
             , m_inv_1_less_q(1./(1.-q))
             , m_factor((1.-q)/(2.-q)) {}
 
@@ -71,6 +74,14 @@ namespace rjmcmc
             if(v<=0.) return 0.;
             return green_ratio*std::pow(v, m_inv_1_less_q);
         }
+
+        /// inverse of the acceptance rule : the modification is rejected by the uniform variate u if delta is greater than this bound
+        /// (there is no such bound for q>2, where the acceptance probability increases with delta)
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            if(m_q>=2.) return std::numeric_limits<double>::infinity();
+            return temperature*(1.-std::pow(u/green_ratio, 1.-m_q))/m_factor;
+        }
     };
 
 } // namespace rjmcmc
@@ -54,6 +54,12 @@ namespace rjmcmc
         {
             return green_ratio*exp(-delta/temperature);
         }
+
+        /// inverse of the acceptance rule : the modification is rejected by the uniform variate u if delta is greater than this bound
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            return temperature*log(green_ratio/u);
+        }
     };
 
 } // namespace rjmcmc
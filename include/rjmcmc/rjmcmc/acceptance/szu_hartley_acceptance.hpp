@@ -37,6 +37,9 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef SZU_HARTLEY_ACCEPTANCE_HPP
 #define SZU_HARTLEY_ACCEPTANCE_HPP
 
+#include <cmath>
+#include <limits>
+
 namespace rjmcmc
 {
     /**
@@ -55,6 +58,13 @@ namespace rjmcmc
         {
             return green_ratio/(1.+exp(delta/temperature));
         }
+
+        /// inverse of the acceptance rule : the modification is rejected by the uniform variate u if delta is greater than this bound
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            if(green_ratio<=u) return -std::numeric_limits<double>::infinity();
+            return temperature*log(green_ratio/u-1.);
+        }
     };
 
 } // namespace rjmcmc
@@ -37,6 +37,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef TSALLIS_STARIOLO_ACCEPTANCE_HPP
 #define TSALLIS_STARIOLO_ACCEPTANCE_HPP
 
+#include <cmath>
+
 namespace rjmcmc
 {
     /**
@@ -61,7 +63,7 @@ namespace rjmcmc
 
     public:
         tsallis_tsariolo_acceptance(double q)
-            , m_q(q)
+            : m_q(q)
             , m_inv_1_less_q(1./(1.-q)) {}
 
         inline double operator()(double delta, double temperature, double green_ratio) const
@@ -70,6 +72,12 @@ namespace rjmcmc
             if(v<=0.) return 0.;
             return green_ratio*std::pow(v, m_inv_1_less_q);
         }
+
+        /// inverse of the acceptance rule : the modification is rejected by the uniform variate u if delta is greater than this bound
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            return temperature*(1.-std::pow(u/green_ratio, 1.-m_q))/(1.-m_q);
+        }
     };
 
 } // namespace rjmcmc
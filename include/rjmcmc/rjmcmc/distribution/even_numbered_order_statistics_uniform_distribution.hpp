@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define EVEN_NUMBERED_ORDER_STATISTICS_UNIFORM_DISTRIBUTION_HPP
 
 #include <boost/random/uniform_real_distribution.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 // boost::math::uniform is not used as it is linked to real values rather than discrete integral values
 
 namespace rjmcmc {
@@ -90,6 +91,9 @@ namespace rjmcmc {
                 *out++ = *it;
         }
 
+        friend void save_state(std::ostream&, const even_numbered_order_statistics_uniform_distribution&) {}
+        friend void load_state(std::istream&, even_numbered_order_statistics_uniform_distribution&) {}
+
     private:
         mutable rand_distribution_type m_rand;
         int_type m_size;
@@ -39,6 +39,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include <boost/random/gamma_distribution.hpp>
 #include <boost/math/distributions/gamma.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -68,6 +69,9 @@ namespace rjmcmc {
         template<typename Engine>
         inline real_type operator()(Engine& e) const { return m_rand(e); }
 
+        friend void save_state(std::ostream&, const gamma_distribution&) {}
+        friend void load_state(std::istream&, gamma_distribution&) {}
+
     private:
         mutable rand_distribution_type m_rand;
         math_distribution_type m_math;
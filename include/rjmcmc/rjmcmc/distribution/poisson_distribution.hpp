@@ -39,6 +39,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include <boost/random/poisson_distribution.hpp>
 #include <boost/math/distributions/poisson.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -72,6 +73,9 @@ namespace rjmcmc {
         template<typename Engine>
         inline int_type operator()(Engine& e) const { return m_rand(e); }
 
+        friend void save_state(std::ostream&, const poisson_distribution&) {}
+        friend void load_state(std::istream&, poisson_distribution&) {}
+
     private:
         mutable rand_distribution_type m_rand;
         math_distribution_type m_math;
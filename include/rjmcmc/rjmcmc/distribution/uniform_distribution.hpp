@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define UNIFORM_DISTRIBUTION_HPP
 
 #include <boost/random/uniform_smallint.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 // boost::math::uniform is not used as it is linked to real values rather than discrete integral values
 
 namespace rjmcmc {
@@ -68,6 +69,9 @@ namespace rjmcmc {
         template<typename Engine>
         inline int_type operator()(Engine& e) const { return m_rand(e); }
 
+        friend void save_state(std::ostream&, const uniform_distribution&) {}
+        friend void load_state(std::istream&, uniform_distribution&) {}
+
     private:
         mutable rand_distribution_type m_rand;
         real_type m_pdf;
@@ -47,6 +47,7 @@ public:
     template<typename T> result_type operator()(const T &) const { return m_energy; }
     template<typename T,typename U> result_type operator()(const T &, const U &) const { return m_energy; }
     constant_energy(Value energy) { m_energy = energy; }
+    friend inline bool is_non_negative(const constant_energy& e) { return e.m_energy>=0; }
 
 private:
     Value m_energy;
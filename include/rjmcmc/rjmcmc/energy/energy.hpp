@@ -49,6 +49,10 @@ public:
 	typedef energy_tag is_energy;
 };
 
+// whether an energy is known to only take non-negative values, which allows the early rejection of proposals.
+// energies may overload it as a friend function found by ADL, the default answer being the conservative one.
+template<typename Energy> inline bool is_non_negative(const Energy&) { return false; }
+
 }
 
 #endif // ENERGY_HPP
@@ -66,6 +66,8 @@ public:
     template<typename T,typename U> result_type operator()(const T &t, const U &u) const { return m_operator(m_energy0(t,u),m_energy1(t,u)); }
     binary_operator_energy(const Energy0& energy0, const Energy1& energy1, Operator op=Operator())
         : m_energy0(energy0), m_energy1(energy1), m_operator(op) {}
+    inline const Energy0& energy0() const { return m_energy0; }
+    inline const Energy1& energy1() const { return m_energy1; }
 
 private:
     Energy0 m_energy0;
@@ -88,6 +90,10 @@ struct plus_energy : public binary_operator_energy<Energy0,Energy1,std::plus<typ
 {
     plus_energy(const Energy0& energy0, const Energy1& energy1)
         :  binary_operator_energy<Energy0,Energy1,std::plus<typename Energy0::result_type> >(energy0,energy1) {}
+    friend inline bool is_non_negative(const plus_energy& e) {
+        using rjmcmc::is_non_negative;
+        return is_non_negative(e.energy0()) && is_non_negative(e.energy1());
+    }
 };
 
 template<typename Energy0, typename Energy1>
@@ -102,6 +108,10 @@ struct multiplies_energy : public binary_operator_energy<Energy0,Energy1,std::mu
 {
     multiplies_energy(const Energy0& energy0, const Energy1& energy1)
         :  binary_operator_energy<Energy0,Energy1,std::multiplies<typename Energy0::result_type> >(energy0,energy1) {}
+    friend inline bool is_non_negative(const multiplies_energy& e) {
+        using rjmcmc::is_non_negative;
+        return is_non_negative(e.energy0()) && is_non_negative(e.energy1());
+    }
 };
 
 template<typename Energy0, typename Energy1>
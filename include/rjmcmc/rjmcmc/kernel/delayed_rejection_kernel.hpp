@@ -0,0 +1,163 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef RJMCMC_DELAYED_REJECTION_KERNEL_HPP
+#define RJMCMC_DELAYED_REJECTION_KERNEL_HPP
+
+#include <boost/random/uniform_real.hpp>
+#include "rjmcmc/rjmcmc/kernel/kernel.hpp"
+
+namespace rjmcmc {
+
+    /**
+     * Kernel adapter that, after the rejection of a proposal of the wrapped rjmcmc::kernel,
+     * lets the sampler try a second, more conservative proposal on the same objects :
+     * its variates are drawn uniformly in a box of half-width `scale` around the variates that leave
+     * the objects unchanged. The sampler accepts it with the Tierney-Mira probability, which preserves reversibility.
+     *
+     * Both branches of the wrapped kernel must share their view and variate types, and its transform must
+     * provide neutral_variate and ghost_variate (eg rectangle_edge_translation_transform and rectangle_corner_translation_transform) :
+     * the objects reachable from a selected object are then reachable from each other with the same uniform density.
+     */
+    template<typename Kernel> class delayed_rejection_kernel;
+
+    //[delayed_rejection_kernel_signature
+    template<typename View, typename Variate, typename Transform>
+    class delayed_rejection_kernel< kernel<View,View,Variate,Variate,Transform> >
+    //]
+    {
+        typedef kernel<View,View,Variate,Variate,Transform> kernel_type;
+        enum { dimension = Transform::dimension };
+        enum { variate_dimension = Transform::dimension-View::dimension };
+
+        kernel_type m_kernel;
+        double m_scale;
+        mutable boost::uniform_real<> m_rand;
+        // state of the latest first stage proposal
+        mutable unsigned int m_kernel_id;
+        mutable double m_val0[dimension];
+        mutable double m_phi0, m_J0;
+
+    public:
+        enum { size = kernel_type::size };
+        enum { max_modification_size = kernel_type::max_modification_size };
+        enum { delayed_rejection = 1 };
+
+        delayed_rejection_kernel(const kernel_type& k, double scale=0.1)
+            : m_kernel(k), m_scale(scale), m_rand(-1,1), m_kernel_id(0) {}
+
+        inline unsigned int kernel_id() const { return m_kernel_id; }
+        inline const std::string& name(unsigned int i) const { return m_kernel.name(i); }
+        inline void name(unsigned int i, const std::string& s) { m_kernel.name(i,s); }
+        inline double probability() const { return m_kernel.probability(); }
+        inline void probability(double p) { m_kernel.probability(p); }
+        inline double scale() const { return m_scale; }
+        inline void scale(double s) { m_scale = s; }
+
+        // first stage : same proposal as the wrapped kernel, whose state is kept for the second stage
+        template<typename Engine, typename Configuration, typename Modification>
+        double operator()(Engine& e, double p, Configuration& c, Modification& modif) const
+        {
+            m_kernel_id = (p<m_kernel.probability01()) ? 0 : 1;
+            double *var0 = m_val0 + View::dimension;
+            m_J0   = m_kernel.view0()(e,c,modif,m_val0);
+            if(m_J0==0) return 0;
+            m_phi0 = m_kernel.variate0()(e,var0);
+            if(m_phi0==0) return 0;
+            return proposal(c,modif,m_val0);
+        }
+
+        // second stage : same branch and objects as the rejected first stage proposal, with variates close to the neutral ones
+        template<typename Engine, typename Configuration, typename Modification>
+        double second_stage(Engine& e, const Configuration& c, const Modification& first, Modification& second) const
+        {
+            if(m_J0==0 || m_phi0==0) return 0;
+            double val0[dimension];
+            double *var0 = val0 + View::dimension;
+            double *var1 = m_val0 + View::dimension;
+            std::copy(m_val0, var1, val0);
+            m_kernel.transform().neutral_variate(val0,var0);
+            for(unsigned int i=0; i<variate_dimension; ++i) var0[i] += m_scale*m_rand(e);
+            if(m_kernel.variate0().pdf(var0)==0) return 0;
+
+            // the ghost first stage proposal, from the second stage proposal to the rejected one
+            double ghost[variate_dimension];
+            m_kernel.transform().ghost_variate(val0,var1,var0,ghost);
+            double phi_ghost = m_kernel.variate0().pdf(ghost);
+            if(phi_ghost==0) return 0;
+
+            second.death() = first.death();
+            return proposal(c,second,val0)*phi_ghost/m_phi0;
+        }
+
+        template<typename Engine, typename Configuration, typename Modification>
+        friend double delayed_proposal(const delayed_rejection_kernel& k, Engine& e, const Configuration& c,
+                                       const Modification& first, Modification& second)
+        {
+            return k.second_stage(e,c,first,second);
+        }
+
+        friend void save_state(std::ostream& os, const delayed_rejection_kernel& k) { write_binary(os,k.m_scale); save_state(os,k.m_kernel); }
+        friend void load_state(std::istream& is, delayed_rejection_kernel& k) { read_binary(is,k.m_scale); load_state(is,k.m_kernel); }
+
+    private:
+        // applies the transform of the current branch to val0, fills the births of modif and returns the kernel ratio
+        template<typename Configuration, typename Modification>
+        double proposal(const Configuration& c, Modification& modif, const double *val0) const
+        {
+            double val1[dimension];
+            const double *var0 = val0 + View::dimension;
+            double *var1 = val1 + View::dimension;
+            double jacob = m_kernel_id ? m_kernel.transform().template apply<1>(val0,val1)
+                                       : m_kernel.transform().template apply<0>(val0,val1);
+            double phi1  = m_kernel.variate1().pdf(var1);
+            double J1    = m_kernel.view1().inverse_pdf(c,modif,val1);
+            double p01   = m_kernel_id ? m_kernel.probability10() : m_kernel.probability01();
+            double p10   = m_kernel_id ? m_kernel.probability01() : m_kernel.probability10();
+            return jacob*(p10*J1*phi1)/(p01*m_J0*m_kernel.variate0().pdf(var0));
+        }
+    };
+
+    template<typename Kernel>
+    delayed_rejection_kernel<Kernel> make_delayed_rejection_kernel(const Kernel& k, double scale=0.1)
+    {
+        return delayed_rejection_kernel<Kernel>(k,scale);
+    }
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_DELAYED_REJECTION_KERNEL_HPP
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RJMCMC_KERNEL_HPP
 
 #include <string>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -60,6 +61,8 @@ namespace rjmcmc {
 
     public:
         enum { size = 2 };
+        enum { max_modification_size = ((int)View0::max_size > (int)View1::max_size) ? (int)View0::max_size : (int)View1::max_size };
+        enum { delayed_rejection = 0 }; // no second stage after a rejection (see delayed_rejection_kernel)
         inline unsigned int kernel_id() const { return m_kernel_id; }
         inline const std::string& name(unsigned int i) const { return m_name[i]; }
         inline void name(unsigned int i, const std::string& s) { m_name[i]=s; }
@@ -75,6 +78,32 @@ namespace rjmcmc {
             m_name[0]=m_name[1]="kernel";
         }
         inline double probability() const { return m_p; }
+        inline double probability01() const { return m_p01; }
+        inline double probability10() const { return m_p10; }
+        inline const View0& view0() const { return m_view0; }
+        inline const View1& view1() const { return m_view1; }
+        inline const Variate0& variate0() const { return m_variate0; }
+        inline const Variate1& variate1() const { return m_variate1; }
+        inline const Transform& transform() const { return m_transform; }
+        // changes the probability of the kernel, keeping the probabilities of its two branches in the same ratio
+        inline void probability(double p) {
+            double q = (m_p01+m_p10>0) ? m_p01/(m_p01+m_p10) : 0.5;
+            m_p = p; m_p01 = p*q; m_p10 = p*(1.-q);
+        }
+
+        // the probabilities, which may be adapted during the optimization, and the state of the variates
+        friend void save_state(std::ostream& os, const kernel& k) {
+            using rjmcmc::save_state;
+            write_binary(os,k.m_p); write_binary(os,k.m_p01); write_binary(os,k.m_p10);
+            save_state(os,k.m_variate0);
+            save_state(os,k.m_variate1);
+        }
+        friend void load_state(std::istream& is, kernel& k) {
+            using rjmcmc::load_state;
+            read_binary(is,k.m_p); read_binary(is,k.m_p01); read_binary(is,k.m_p10);
+            load_state(is,k.m_variate0);
+            load_state(is,k.m_variate1);
+        }
 
         // prerequisite : p is uniform between 0 and probability()=m_p
         template<typename Engine, typename Configuration, typename Modification>
@@ -108,6 +137,14 @@ namespace rjmcmc {
         }
     };
 
+    // second stage proposal after the rejection of the modification first proposed by k (see delayed_rejection_kernel).
+    // kernels without a second stage return 0.
+    template<typename Kernel, typename Engine, typename Configuration, typename Modification>
+    inline double delayed_proposal(const Kernel&, Engine&, const Configuration&, const Modification&, Modification&)
+    {
+        return 0;
+    }
+
 }; // namespace rjmcmc
 
 #endif // RJMCMC_KERNEL_HPP
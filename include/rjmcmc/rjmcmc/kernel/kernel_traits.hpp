@@ -44,9 +44,14 @@ knowledge of the CeCILL license and that you accept its terms.
 namespace rjmcmc {
     template<typename T> struct kernel_traits {
         enum { size = 0 };
+        enum { max_modification_size = 0 };
+        enum { delayed_rejection = 0 };
     };
     template <class H, class... T> struct kernel_traits < std::tuple<H, T...> > {
         enum { size = H::size + kernel_traits<std::tuple<T...> >::size };
+        enum { max_modification_size = ((int)H::max_modification_size > (int)kernel_traits<std::tuple<T...> >::max_modification_size)
+               ? (int)H::max_modification_size : (int)kernel_traits<std::tuple<T...> >::max_modification_size };
+        enum { delayed_rejection = (int)H::delayed_rejection || (int)kernel_traits<std::tuple<T...> >::delayed_rejection };
     };
 
 }; //namespace rjmcmc
@@ -58,17 +63,26 @@ namespace rjmcmc {
         template<typename T>
         struct kernel_traits_impl {
             enum { size = 0 };
+            enum { max_modification_size = 0 };
+            enum { delayed_rejection = 0 };
         };
 
         template <class H, class T>
                 struct kernel_traits_impl < boost::tuples::cons<H, T> > {
             enum { size = H::size + kernel_traits_impl<T>::size };
+            enum { max_modification_size = ((int)H::max_modification_size > (int)kernel_traits_impl<T>::max_modification_size)
+                   ? (int)H::max_modification_size : (int)kernel_traits_impl<T>::max_modification_size };
+            enum { delayed_rejection = (int)H::delayed_rejection || (int)kernel_traits_impl<T>::delayed_rejection };
         };
 
     } //  namespace internal
 
     template<typename T> struct kernel_traits {
         enum { size = internal::kernel_traits_impl<typename T::inherited>::size };
+        // maximum number of births or deaths of a modification proposed by any of the kernels
+        enum { max_modification_size = internal::kernel_traits_impl<typename T::inherited>::max_modification_size };
+        // whether any of the kernels proposes a second stage after a rejection
+        enum { delayed_rejection = internal::kernel_traits_impl<typename T::inherited>::delayed_rejection };
     };
 
 }; //namespace rjmcmc
@@ -37,6 +37,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef RJMCMC_NULL_VARIATE_HPP
 #define RJMCMC_NULL_VARIATE_HPP
 
+#include "rjmcmc/util/checkpoint.hpp"
+
 namespace rjmcmc {
 
     class null_variate
@@ -53,6 +55,8 @@ namespace rjmcmc {
             return 1.;
         }
         null_variate() {}
+        friend void save_state(std::ostream&, const null_variate&) {}
+        friend void load_state(std::istream&, null_variate&) {}
     };
 
 }; // namespace rjmcmc
@@ -43,6 +43,7 @@ namespace rjmcmc {
     {
     public:
         enum { dimension = 0 };
+        enum { max_size = 0 }; // maximum number of objects selected by the view
         template<typename Engine, typename Configuration, typename Modification, typename OutputIterator>
         inline double operator()(Engine& e, Configuration& c, Modification& modif, OutputIterator it) const {
             return 1.;
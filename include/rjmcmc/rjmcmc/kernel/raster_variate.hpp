@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <boost/random/uniform_real.hpp>
 #include <vector>
 #include <algorithm>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -95,6 +96,10 @@ namespace rjmcmc {
             for(int i=0; i<m_totsize; ++i) m_sum = m_cdf[i+1] = m_sum + pdf[i]; // assert(pdf[i]>=0)
             for(int i=0; i<m_totsize; ++i) m_cdf[i+1]/=m_sum;
         }
+
+        // the raster is fixed during the optimization
+        friend void save_state(std::ostream&, const raster_variate&) {}
+        friend void load_state(std::istream&, raster_variate&) {}
     private:
         std::vector<double> m_cdf;
         std::vector<int> m_size;
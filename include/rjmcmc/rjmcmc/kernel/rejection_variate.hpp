@@ -37,6 +37,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef RJMCMC_REJECTION_VARIATE_HPP
 #define RJMCMC_REJECTION_VARIATE_HPP
 #include <algorithm>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -64,6 +65,13 @@ namespace rjmcmc {
             void pass() const { ++m_test; ++m_pass; m_inv_probability = double(m_test)/m_pass; }
             double inv_probability() const { return m_inv_probability; }
             void clear() {  m_pass = m_test = 0; m_inv_probability = 0.; }
+
+            friend void save_state(std::ostream& os, const monte_carlo& n) {
+                write_binary(os,n.m_test); write_binary(os,n.m_pass); write_binary(os,n.m_inv_probability);
+            }
+            friend void load_state(std::istream& is, monte_carlo& n) {
+                read_binary(is,n.m_test); read_binary(is,n.m_pass); read_binary(is,n.m_inv_probability);
+            }
         };
 
         // Monte Carlo estimation of the success rate of the predicate based on the last N tests
@@ -84,6 +92,13 @@ namespace rjmcmc {
                 m_pass=0;
                 m_inv_probability = 0.;
             }
+
+            friend void save_state(std::ostream& os, const sliding_monte_carlo& n) {
+                write_binary(os,n.m_test); write_binary(os,n.m_i); write_binary(os,n.m_pass); write_binary(os,n.m_inv_probability);
+            }
+            friend void load_state(std::istream& is, sliding_monte_carlo& n) {
+                read_binary(is,n.m_test); read_binary(is,n.m_i); read_binary(is,n.m_pass); read_binary(is,n.m_inv_probability);
+            }
         };
         // Monte Carlo estimation of the success rate of the predicate based with (decay^n) sample weights where n is the age of the sample (in number of iterations)
         class decay_monte_carlo
@@ -105,6 +120,9 @@ namespace rjmcmc {
             void pass() const { m_inv_probability /= m_decay+(1.-m_decay)*m_inv_probability; }
             double inv_probability() const { return m_inv_probability; }
             void clear() { m_inv_probability = 1.; }
+
+            friend void save_state(std::ostream& os, const decay_monte_carlo& n) { write_binary(os,n.m_inv_probability); }
+            friend void load_state(std::istream& is, decay_monte_carlo& n) { read_binary(is,n.m_inv_probability); }
         };
     }
 
@@ -146,6 +164,10 @@ namespace rjmcmc {
             : m_variate(variate),  m_pred(pred), m_normalizer(normalizer)
         {
         }
+
+        // the adaptive state is the one of the normalizer
+        friend void save_state(std::ostream& os, const rejection_variate& v) { using rjmcmc::save_state; save_state(os,v.m_normalizer); }
+        friend void load_state(std::istream& is, rejection_variate& v) { using rjmcmc::load_state; load_state(is,v.m_normalizer); }
     };
 
 }; // namespace rjmcmc
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RJMCMC_SIMPLEX_VARIATE_HPP
 
 #include <boost/random/uniform_real.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -183,6 +184,8 @@ namespace rjmcmc {
             return m_pdf;
         }
         simplex_variate() : m_rand(0,1), m_pdf(1./factorial<N>::value) {}
+        friend void save_state(std::ostream&, const simplex_variate&) {}
+        friend void load_state(std::istream&, simplex_variate&) {}
 
     };
 
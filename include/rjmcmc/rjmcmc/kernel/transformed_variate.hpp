@@ -37,6 +37,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef RJMCMC_TRANSFORMED_VARIATE_HPP
 #define RJMCMC_TRANSFORMED_VARIATE_HPP
 
+#include "rjmcmc/util/checkpoint.hpp"
+
 namespace rjmcmc {
 
     template<typename Transform, typename Variate = typename rjmcmc::variate<Transform::dimension> > // assert(Transform::dimension==Variate::dimension)
@@ -65,6 +67,9 @@ namespace rjmcmc {
         }
         transformed_variate(const Transform& transform, const Variate& variate)
             : m_transform(transform), m_variate(variate) {}
+
+        friend void save_state(std::ostream& os, const transformed_variate& v) { using rjmcmc::save_state; save_state(os,v.m_variate); }
+        friend void load_state(std::istream& is, transformed_variate& v) { using rjmcmc::load_state; load_state(is,v.m_variate); }
     };
 
 }; // namespace rjmcmc
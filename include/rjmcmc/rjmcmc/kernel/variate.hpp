@@ -39,6 +39,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include <boost/random/uniform_real.hpp>
 #include "null_variate.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace rjmcmc {
 
@@ -62,10 +63,15 @@ namespace rjmcmc {
             return 1.;
         }
         variate() : m_rand(0,1) {}
+        friend void save_state(std::ostream&, const variate&) {}
+        friend void load_state(std::istream&, variate&) {}
     };
 
 
-    template<> class variate<0> : public null_variate {};
+    template<> class variate<0> : public null_variate {
+        friend void save_state(std::ostream&, const variate&) {}
+        friend void load_state(std::istream&, variate&) {}
+    };
 
 }; // namespace rjmcmc
 
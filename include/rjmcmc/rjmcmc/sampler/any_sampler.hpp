@@ -38,9 +38,15 @@ knowledge of the CeCILL license and that you accept its terms.
 #define ANY_SAMPLER_HPP
 
 #include "sampler.hpp"
+#include "kernel_statistics.hpp"
 
 namespace rjmcmc {
 
+    /// whether the temperatures of `schedule` may be computed ahead of the iterations they drive (default : yes).
+    /// Schedules reading the wall clock at each increment return false, so that they are advanced between the iterations.
+    template<typename Schedule>
+    inline bool prefetch_temperatures(const Schedule&) { return true; }
+
     namespace detail {
 
         template<typename Engine, typename Configuration>
@@ -52,9 +58,13 @@ namespace rjmcmc {
 
             virtual const sampler_base* base() const=0;
             virtual void operator()(Engine& e, Configuration &c, double temp) = 0;
+            virtual void run(Engine& e, Configuration &c, const double *temp, unsigned int n,
+                             kernel_statistics *stats) = 0;
             virtual const std::string&  kernel_name(unsigned int i) const = 0;
             virtual unsigned int kernel_id  () const = 0;
             virtual unsigned int kernel_size() const = 0;
+            virtual void save(std::ostream& os) const = 0;
+            virtual void load(std::istream& is) = 0;
         };
 
         template<typename Engine, typename Configuration, typename T>
@@ -66,9 +76,17 @@ namespace rjmcmc {
 
             virtual const sampler_base* base() const { return &held; }
             virtual void operator()(Engine& e, Configuration &c, double temp)  { held(e,c,temp); }
+            virtual void run(Engine& e, Configuration &c, const double *temp, unsigned int n,
+                             kernel_statistics *stats)
+            {
+                if(stats) for(unsigned int i=0; i<n; ++i) { held(e,c,temp[i]); (*stats)(held); }
+                else      for(unsigned int i=0; i<n; ++i) { held(e,c,temp[i]); }
+            }
             virtual const std::string& kernel_name(unsigned int i) const  { return held.kernel_name(i); }
             virtual unsigned int kernel_id  () const  { return held.kernel_id(); }
             virtual unsigned int kernel_size() const { return held.kernel_size(); }
+            virtual void save(std::ostream& os) const { using rjmcmc::save_state; save_state(os,held); }
+            virtual void load(std::istream& is) { using rjmcmc::load_state; load_state(is,held); }
 
         private:
             T held;
@@ -104,6 +122,37 @@ namespace rjmcmc {
 
         // sampling step
         void operator()(Engine& e, Configuration &c, double temp) { (*content)(e,c,temp); }
+        // n sampling steps at temperatures temp[0..n-1], with a single virtual call
+        void run(Engine& e, Configuration &c, const double *temp, unsigned int n,
+                 kernel_statistics *stats = NULL)
+        {
+            content->run(e,c,temp,n,stats);
+        }
+
+        // batched overload of simulated_annealing::run_iterations
+        template<typename Schedule>
+        friend double run_iterations(Engine& e, Configuration& c, any_sampler& s, Schedule& schedule, double t,
+                                     unsigned int n, kernel_statistics *stats)
+        {
+            if(!prefetch_temperatures(schedule))
+            {
+                for(; n; --n, t = *(++schedule)) { s(e,c,t); if(stats) (*stats)(s); }
+                return t;
+            }
+            double temp[batch_size];
+            while(n)
+            {
+                unsigned int m = n<batch_size ? n : batch_size;
+                for(unsigned int i=0; i<m; ++i, t = *(++schedule)) temp[i] = t;
+                s.run(e,c,temp,m,stats);
+                n -= m;
+            }
+            return t;
+        }
+
+        friend void save_state(std::ostream& os, const any_sampler& s) { s.content->save(os); }
+        friend void load_state(std::istream& is, any_sampler& s) { s.content->load(is); }
+
         // statistics accessors
         inline const std::string&  kernel_name(unsigned int i) const { return content->kernel_name(i); }
         inline unsigned int kernel_id  () const { return content->kernel_id(); }
@@ -117,8 +166,10 @@ namespace rjmcmc {
         inline bool accepted() const { return content->base()->accepted(); }
         inline double kernel_ratio() const { return content->base()->kernel_ratio(); }
         inline double ref_pdf_ratio() const { return content->base()->ref_pdf_ratio(); }
+        inline bool early_rejected() const { return content->base()->early_rejected(); }
 
     private:
+        enum { batch_size = 256 };
         detail::sampler_placeholder<Engine,Configuration>* content;
     };
 
@@ -0,0 +1,116 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef RJMCMC_KERNEL_STATISTICS_HPP
+#define RJMCMC_KERNEL_STATISTICS_HPP
+
+#include <vector>
+#include "rjmcmc/util/checkpoint.hpp"
+
+namespace rjmcmc
+{
+    /**
+     * Per-kernel proposal and acceptance counts, accumulated by chunked_optimize
+     * over the iterations that are not visited.
+     */
+    class kernel_statistics
+    {
+    public:
+        template<typename Sampler>
+        void begin(const Sampler& sampler)
+        {
+            m_proposed.assign(sampler.kernel_size(),0);
+            m_accepted.assign(sampler.kernel_size(),0);
+        }
+
+        template<typename Sampler>
+        inline void operator()(const Sampler& sampler)
+        {
+            unsigned int k = sampler.kernel_id();
+            ++m_proposed[k];
+            m_accepted[k] += sampler.accepted();
+        }
+
+        void reset()
+        {
+            m_proposed.assign(m_proposed.size(),0);
+            m_accepted.assign(m_accepted.size(),0);
+        }
+
+        kernel_statistics& operator+=(const kernel_statistics& s)
+        {
+            for(unsigned int k=0; k<s.size(); ++k) {
+                m_proposed[k] += s.m_proposed[k];
+                m_accepted[k] += s.m_accepted[k];
+            }
+            return *this;
+        }
+
+        inline unsigned int size() const { return m_proposed.size(); }
+        inline unsigned int proposed(unsigned int k) const { return m_proposed[k]; }
+        inline unsigned int accepted(unsigned int k) const { return m_accepted[k]; }
+
+        friend void save_state(std::ostream& os, const kernel_statistics& s)
+        {
+            write_binary(os,boost::uint32_t(s.size()));
+            for(unsigned int k=0; k<s.size(); ++k) {
+                write_binary(os,boost::uint32_t(s.m_proposed[k]));
+                write_binary(os,boost::uint32_t(s.m_accepted[k]));
+            }
+        }
+        friend void load_state(std::istream& is, kernel_statistics& s)
+        {
+            boost::uint32_t n = 0, proposed = 0, accepted = 0;
+            read_binary(is,n);
+            s.m_proposed.assign(n,0);
+            s.m_accepted.assign(n,0);
+            for(unsigned int k=0; k<n && is; ++k) {
+                read_binary(is,proposed);
+                read_binary(is,accepted);
+                s.m_proposed[k] = proposed;
+                s.m_accepted[k] = accepted;
+            }
+        }
+
+    private:
+        std::vector<unsigned int> m_proposed;
+        std::vector<unsigned int> m_accepted;
+    };
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_KERNEL_STATISTICS_HPP
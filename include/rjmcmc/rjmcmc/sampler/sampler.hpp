@@ -39,9 +39,11 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include "rjmcmc/util/tuple.hpp"
 #include "rjmcmc/util/random_apply.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
 #include "rjmcmc/rjmcmc/kernel/kernel_traits.hpp"
 #include "rjmcmc/rjmcmc/kernel/kernel.hpp"
 #include <iomanip>
+#include <algorithm>
 
 namespace rjmcmc {
 
@@ -56,6 +58,9 @@ namespace rjmcmc {
         inline bool accepted() const { return m_accepted; }
         inline double kernel_ratio() const { return m_kernel_ratio; }
         inline double ref_pdf_ratio() const { return m_ref_pdf_ratio; }
+        /// whether the proposal was rejected before the full evaluation of its energy variation :
+        /// delta() is then only a lower bound of the energy variation, and acceptance_probability() an upper bound
+        inline bool early_rejected() const { return m_early_rejected; }
 
     protected:
         double  m_acceptance_probability;
@@ -65,6 +70,7 @@ namespace rjmcmc {
         double  m_kernel_ratio;
         double  m_ref_pdf_ratio;
         bool    m_accepted;
+        bool    m_early_rejected;
     };
 
     namespace detail
@@ -106,6 +112,21 @@ namespace rjmcmc {
                 return t(m_e,x,m_c,m_m);
             }
         };
+
+        template<typename Engine, typename Configuration, typename Modification>
+        struct delayed_proposal_functor
+        {
+            Engine& m_e;
+            const Configuration& m_c;
+            const Modification& m_first;
+            Modification& m_second;
+            typedef double result_type;
+            delayed_proposal_functor(Engine& e, const Configuration &c, const Modification &first, Modification &second)
+                : m_e(e), m_c(c), m_first(first), m_second(second) {}
+            template<typename T> inline result_type operator()(double, const T& t) {
+                return delayed_proposal(t,m_e,m_c,m_first,m_second);
+            }
+        };
     }
 
     template<typename Density, typename Acceptance, RJMCMC_TUPLE_TYPENAMES >
@@ -118,42 +139,74 @@ namespace rjmcmc {
                 m_rand(0,1),
                 m_density(d),
                 m_acceptance(a),
-                m_kernel(RJMCMC_TUPLE_PARAMS)
+                m_kernel(RJMCMC_TUPLE_PARAMS),
+                m_kernel_table(m_kernel)
         {}
 
 
         enum { size = tuple_size<Kernels>::value };
         enum { m_kernel_size = kernel_traits<Kernels>::size };
+        enum { max_modification_size = kernel_traits<Kernels>::max_modification_size };
 
         /// This is the main sampling function, performing an RJMCMC step on the configuration c in place, using the source of entropy e
         template<typename Engine, typename Configuration>
         void operator()(Engine& e, Configuration &c, double temp)
         {
-            typedef typename Configuration::modification Modification;
-
-            //1 & 2
+            // the kernels bound the size of the modifications : they are stored in place, without allocation
+            typedef typename Configuration::template bounded_modification<max_modification_size>::type Modification;
             Modification modif;
             m_temperature = temp;
-            detail::kernel_functor<Engine,Configuration,Modification> kf(e,c,modif);
-            m_kernel_ratio = random_apply(m_kernel_id,m_rand(e),m_kernel,kf);
 
-            //3
-            m_ref_pdf_ratio = m_density.pdf_ratio(c,modif);
-            m_green_ratio = m_kernel_ratio*m_ref_pdf_ratio;
+            //1 & 2 & 3
+            draw(e,c,modif);
 
             //4
+            m_early_rejected = false;
             if(m_green_ratio<=0) {
                 m_delta   =0;
                 m_accepted=false;
                 return;
             }
-            m_delta       = c.delta_energy(modif);
+            // early rejection : the uniform variate is drawn first and turned into a bound above which the energy variation leads to a rejection,
+            // so that its evaluation may stop as soon as it exceeds the bound (m_delta is then only a lower bound of the energy variation)
+            double u      = m_rand(e);
+            double bound  = m_acceptance.max_delta(u,m_temperature,m_green_ratio);
+            m_delta       = c.delta_energy(modif,bound);
             m_acceptance_probability  = m_acceptance(m_delta,m_temperature,m_green_ratio);
+            m_early_rejected = (m_delta>bound);
 
             //5
+            m_accepted    = !m_early_rejected && ( u < m_acceptance_probability );
+            if (m_accepted) modif.apply(c);
+            else if (kernel_traits<Kernels>::delayed_rejection) delayed_rejection(e,c,modif,bound);
+        }
+
+        /// Steps 1 to 4 : proposes the modification modif of c and evaluates its green ratio and its energy variation, leaving c unchanged
+        template<typename Engine, typename Configuration, typename Modification>
+        void propose(Engine& e, Configuration &c, Modification &modif)
+        {
+            //1 & 2 & 3
+            draw(e,c,modif);
+
+            //4
+            m_delta = (m_green_ratio<=0) ? 0 : c.delta_energy(modif);
+            m_early_rejected = false;
+        }
+
+        /// Step 5 : accepts or rejects the latest proposed modification at temperature temp, applying it to c if accepted
+        template<typename Engine, typename Configuration, typename Modification>
+        bool accept(Engine& e, Configuration &c, const Modification &modif, double temp)
+        {
+            m_temperature = temp;
+            if(m_green_ratio<=0) {
+                m_accepted=false;
+                return false;
+            }
+            m_acceptance_probability  = m_acceptance(m_delta,m_temperature,m_green_ratio);
             m_accepted    = ( m_rand(e) < m_acceptance_probability );
             if (m_accepted) modif.apply(c);
             //modif.apply(c,m_accepted);
+            return m_accepted;
         }
 
     public:
@@ -169,12 +222,78 @@ namespace rjmcmc {
         ///  statistics accessor : getting the number of kernels
         inline unsigned int kernel_size() const { return m_kernel_size; }
 
+        ///  Getting the probability of the Ith kernel
+        template<unsigned int I> inline double kernel_probability() const { return get<I>(m_kernel).probability(); }
+
+        ///  Setting the probability of the Ith kernel, refreshing the kernel selection table
+        template<unsigned int I> inline void kernel_probability(double p)
+        {
+            get<I>(m_kernel).probability(p);
+            m_kernel_table.refresh(m_kernel);
+        }
+
+        /// adaptive state of the reference process and of the kernels
+        friend void save_state(std::ostream& os, const sampler& s)
+        {
+            using rjmcmc::save_state;
+            save_state(os,s.m_density);
+            internal::save_state_all f(os);
+            rjmcmc::for_each(const_cast<Kernels&>(s.m_kernel),f);
+        }
+        friend void load_state(std::istream& is, sampler& s)
+        {
+            using rjmcmc::load_state;
+            load_state(is,s.m_density);
+            internal::load_state_all f(is);
+            rjmcmc::for_each(s.m_kernel,f);
+            s.m_kernel_table.refresh(s.m_kernel);
+        }
+
     private:
+        // steps 1 to 3 : draws a kernel and a modification, and evaluates its green ratio
+        template<typename Engine, typename Configuration, typename Modification>
+        void draw(Engine& e, Configuration &c, Modification &modif)
+        {
+            detail::kernel_functor<Engine,Configuration,Modification> kf(e,c,modif);
+            m_kernel_ratio = m_kernel_table(m_kernel_id,m_rand(e),m_kernel,kf);
+            m_ref_pdf_ratio = m_density.pdf_ratio(c,modif);
+            m_green_ratio = m_kernel_ratio*m_ref_pdf_ratio;
+        }
+
+        // second stage of a delayed_rejection_kernel after the rejection of the modification first,
+        // accepted with the Tierney-Mira probability that preserves the reversibility of the chain
+        template<typename Engine, typename Configuration, typename Modification>
+        void delayed_rejection(Engine& e, Configuration &c, const Modification &first, double bound)
+        {
+            Modification second;
+            detail::delayed_proposal_functor<Engine,Configuration,Modification> f(e,c,first,second);
+            double kernel_ratio = detail::random_apply_at<0,size>()(m_kernel_id,0.,m_kernel,f);
+            if(kernel_ratio<=0) return;
+
+            // the first stage probabilities of x->y1 and of the ghost move y2->y1 require the exact energy variations
+            double delta1 = (m_delta>bound) ? c.delta_energy(first) : m_delta;
+            double alpha1 = (std::min)(1.,m_acceptance(delta1,m_temperature,m_green_ratio));
+            if(alpha1>=1) return;
+            double ref_pdf_ratio1 = m_ref_pdf_ratio;
+            m_ref_pdf_ratio = m_density.pdf_ratio(c,second);
+            m_delta = c.delta_energy(second);
+            m_early_rejected = false;
+            double ghost_green_ratio = ref_pdf_ratio1/(m_ref_pdf_ratio*m_kernel_ratio);
+            double ghost_alpha1 = (std::min)(1.,m_acceptance(delta1-m_delta,m_temperature,ghost_green_ratio));
+
+            m_kernel_ratio = kernel_ratio*(1.-ghost_alpha1)/(1.-alpha1);
+            m_green_ratio  = m_kernel_ratio*m_ref_pdf_ratio;
+            m_acceptance_probability = m_acceptance(m_delta,m_temperature,m_green_ratio);
+            m_accepted     = ( m_rand(e) < m_acceptance_probability );
+            if (m_accepted) second.apply(c);
+        }
+
         // data
         boost::uniform_real<> m_rand;
         Density    m_density;
         Acceptance m_acceptance;
         Kernels    m_kernel;
+        random_apply_table<size> m_kernel_table;
 
         // statistics
         unsigned int m_kernel_id;
@@ -0,0 +1,253 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef SPECULATIVE_SAMPLER_HPP
+#define SPECULATIVE_SAMPLER_HPP
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include "sampler.hpp"
+#include "rjmcmc/util/random.hpp" // split_stream
+#include "rjmcmc/util/checkpoint.hpp"
+
+namespace rjmcmc {
+
+    /**
+     * \ingroup GroupSampler
+     *
+     * Speculative evaluation of the proposals of a sampler, modeling the Sampler concept.
+     * When its buffer is exhausted, K proposals are generated from the current configuration and evaluated
+     * (kernel, reference pdf ratio and energy variation) concurrently by a pool of threads, each proposal with its own
+     * engine (split from the caller's one at the worker_stream level) and its own copy of the sampler. The proposals are then consumed one per call, the acceptance being decided
+     * at the temperature of this call with the caller's engine. The first accepted proposal is applied and the remaining
+     * ones are discarded, as they were proposed from the configuration before this modification.
+     *
+     * Each consumed proposal is thus an independent proposal from the current configuration, so that the chain has the
+     * same law as the one of the wrapped sampler. This pays off in the cold phase of the annealing where most proposals are rejected.
+     * The buffer is also discarded when the sampler is called on another configuration, or on a configuration whose
+     * size or energy changed since the proposals were drawn. Any other modification of the configuration between two
+     * calls (e.g. a move preserving both its size and its energy) must be followed by a call to reset().
+     */
+    //[speculative_sampler_signature
+    template<typename Engine, typename Configuration, typename Sampler>
+    class speculative_sampler : public sampler_base
+    {
+    public:
+        speculative_sampler(const Sampler& sampler, unsigned int proposals, unsigned int threads=0)
+    //]
+            : m_sampler(sampler), m_proposals(proposals?proposals:1), m_threads(threads), m_next(0), m_resume(0), m_config(NULL), m_size(0), m_energy(0), m_current(NULL)
+        {
+            init();
+        }
+
+        speculative_sampler(const speculative_sampler& s)
+            : m_sampler(s.m_sampler), m_proposals(s.m_proposals), m_threads(s.m_threads), m_next(0), m_resume(0), m_config(NULL), m_size(0), m_energy(0), m_current(NULL)
+        {
+            init();
+        }
+
+        ~speculative_sampler()
+        {
+            if(!m_pool) return;
+            m_quit = true;
+            m_barrier->wait();
+            m_pool->join_all();
+        }
+
+        void operator()(Engine& e, Configuration &c, double temp)
+        {
+            if(m_next==m_slots.size() || m_config!=&c || m_size!=c.size() || m_energy!=c.energy()) fill(e,c);
+            slot& s = m_slots[m_next++];
+            m_current = &s.sampler;
+            s.sampler.accept(e,c,s.modif,temp);
+            if(s.sampler.accepted()) m_next = m_slots.size(); // the remaining proposals are outdated
+
+            m_acceptance_probability = s.sampler.acceptance_probability();
+            m_temperature = s.sampler.temperature();
+            m_delta = s.sampler.delta();
+            m_green_ratio = s.sampler.green_ratio();
+            m_kernel_ratio = s.sampler.kernel_ratio();
+            m_ref_pdf_ratio = s.sampler.ref_pdf_ratio();
+            m_accepted = s.sampler.accepted();
+            m_early_rejected = s.sampler.early_rejected();
+        }
+
+        /// discards the pending proposals, which are drawn again from the configuration at the next call
+        inline void reset() { m_next = m_slots.size(); }
+
+        inline const std::string& kernel_name(unsigned int i) const { return m_sampler.kernel_name(i); }
+        inline unsigned int kernel_id  () const { return m_current ? m_current->kernel_id() : 0; }
+        inline unsigned int kernel_size() const { return m_sampler.kernel_size(); }
+
+        // pending proposals are saved as the engines and samplers that drew them : they are drawn again on resume
+        friend void save_state(std::ostream& os, const speculative_sampler& s)
+        {
+            using rjmcmc::save_state;
+            save_state(os,s.m_sampler);
+            bool pending = (s.m_next<s.m_slots.size());
+            rjmcmc::write_binary(os,boost::uint32_t(s.m_slots.size()));
+            for(unsigned int k=0; k<s.m_slots.size(); ++k)
+            {
+                save_state(os,pending ? s.m_drawn_engines [k] : s.m_slots[k].engine );
+                save_state(os,pending ? s.m_drawn_samplers[k] : s.m_slots[k].sampler);
+            }
+            rjmcmc::write_binary(os,boost::uint32_t(pending ? s.m_next : 0));
+        }
+        friend void load_state(std::istream& is, speculative_sampler& s)
+        {
+            using rjmcmc::load_state;
+            load_state(is,s.m_sampler);
+            boost::uint32_t n = 0, next = 0;
+            rjmcmc::read_binary(is,n);
+            if(n && n!=s.m_proposals) { is.setstate(std::ios::failbit); return; }
+            if(n && s.m_slots.empty()) s.create(NULL);
+            for(unsigned int k=0; k<n; ++k)
+            {
+                load_state(is,s.m_slots[k].engine);
+                load_state(is,s.m_slots[k].sampler);
+            }
+            rjmcmc::read_binary(is,next);
+            s.m_resume = next;
+            s.m_next = s.m_slots.size();
+            s.m_config = NULL;
+        }
+
+    private:
+        typedef typename Configuration::modification Modification;
+        struct slot
+        {
+            slot(const Sampler& s, const Engine& e) : sampler(s), engine(e) {}
+            Sampler sampler;
+            Engine engine;
+            Modification modif;
+        };
+
+        void init()
+        {
+            if(!m_threads) m_threads = boost::thread::hardware_concurrency();
+            if(m_threads>m_proposals) m_threads = m_proposals;
+            if(!m_threads) m_threads = 1;
+            m_quit = false;
+            m_acceptance_probability = m_temperature = m_delta = 0;
+            m_green_ratio = m_kernel_ratio = m_ref_pdf_ratio = 1;
+            m_accepted = m_early_rejected = false;
+        }
+
+        // slots are created with placeholder engines (e==NULL) when they are loaded from a checkpoint
+        void create(Engine *e)
+        {
+            m_slots.reserve(m_proposals);
+            for(unsigned int k=0; k<m_proposals; ++k)
+                m_slots.push_back(slot(m_sampler,e ? split_stream(*e,worker_stream) : Engine()));
+            m_drawn_samplers.assign(m_proposals,m_sampler);
+            m_drawn_engines.assign(m_proposals,m_slots.front().engine);
+        }
+
+        // proposals are dealt round-robin to the threads, and the engines are attached to the proposals :
+        // a run is reproducible for a given number of proposals, whatever the number of threads
+        void fill(Engine& e, Configuration &c)
+        {
+            if(m_slots.empty()) create(&e);
+            if(!m_pool && m_threads>1)
+            {
+                m_barrier.reset(new boost::barrier(m_threads));
+                m_pool.reset(new boost::thread_group);
+                for(unsigned int t=1; t<m_threads; ++t)
+                    m_pool->create_thread(boost::bind(&speculative_sampler::loop,this,t));
+            }
+            for(unsigned int k=0; k<m_slots.size(); ++k)
+            {
+                m_drawn_samplers[k] = m_slots[k].sampler;
+                m_drawn_engines [k] = m_slots[k].engine;
+            }
+            m_config = &c;
+            m_size = c.size();
+            m_energy = c.energy();
+            m_next = 0;
+            if(m_pool) m_barrier->wait(); // evaluation start
+            work(0);
+            if(m_pool) m_barrier->wait(); // evaluation end
+            if(m_resume<m_slots.size()) m_next = m_resume; // proposals consumed before the checkpoint
+            m_resume = 0;
+        }
+
+        void loop(unsigned int t)
+        {
+            for(;;)
+            {
+                m_barrier->wait(); // evaluation start
+                if(m_quit) return;
+                work(t);
+                m_barrier->wait(); // evaluation end
+            }
+        }
+
+        void work(unsigned int t)
+        {
+            for(unsigned int k=t; k<m_slots.size(); k+=m_threads)
+            {
+                slot& s = m_slots[k];
+                s.modif.birth().clear();
+                s.modif.death().clear();
+                s.sampler.propose(s.engine,*m_config,s.modif);
+            }
+        }
+
+        speculative_sampler& operator=(const speculative_sampler&);
+
+        Sampler m_sampler;
+        unsigned int m_proposals;
+        unsigned int m_threads;
+        std::vector<slot> m_slots;
+        std::vector<Sampler> m_drawn_samplers; // state of the slots when the pending proposals were drawn
+        std::vector<Engine> m_drawn_engines;
+        unsigned int m_next, m_resume;
+        Configuration *m_config;
+        std::size_t m_size;
+        double m_energy;
+        const Sampler *m_current;
+        bool m_quit;
+        boost::scoped_ptr<boost::barrier> m_barrier;
+        boost::scoped_ptr<boost::thread_group> m_pool;
+    };
+
+}; // namespace rjmcmc
+
+#endif // SPECULATIVE_SAMPLER_HPP
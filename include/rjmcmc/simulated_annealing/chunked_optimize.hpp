@@ -0,0 +1,147 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef CHUNKED_OPTIMIZE_HPP
+#define CHUNKED_OPTIMIZE_HPP
+
+#include <algorithm>
+#include "boost/concept_check.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
+namespace simulated_annealing
+{
+    /**
+     * Runs `n` iterations of the sampler starting at temperature `t`, accumulating
+     * their statistics in `stats` if not NULL, and returns the next temperature.
+     * Type-erased samplers overload it to dispatch whole batches at once.
+     */
+    //[run_iterations
+    template<typename Engine, typename Configuration, typename Sampler, typename Schedule>
+    inline double run_iterations(Engine& e, Configuration& config, Sampler& sampler, Schedule& schedule, double t,
+                                 unsigned int n, kernel_statistics *stats)
+    {
+        if(stats) for(unsigned int i=0; i<n; ++i, t = *(++schedule)) { sampler(e,config,t); (*stats)(sampler); }
+        else      for(unsigned int i=0; i<n; ++i, t = *(++schedule)) { sampler(e,config,t); }
+        return t;
+    }
+    //]
+
+    namespace internal
+    {
+        template<
+                typename Engine,
+                typename Configuration, typename Sampler,
+                typename Schedule, typename EndTest,
+                typename Visitor
+                >
+                void chunked_optimize(
+                        Engine& e,
+                        Configuration& config, Sampler& sampler,
+                        Schedule& schedule, EndTest& end_test,
+                        Visitor& visitor, kernel_statistics *stats )
+        {
+            BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+            //[chunked_optimize_loop
+            double t = *schedule;
+            visitor.begin(config,sampler,t);
+            if(stats) stats->begin(sampler);
+            for(;;)
+            {
+                unsigned int n = (std::min)(idle_iterations(end_test),idle_iterations(visitor));
+                if(n)
+                {
+                    t = run_iterations(e,config,sampler,schedule,t,n,stats);
+                    skip_iterations(end_test,n,stats);
+                    skip_iterations(visitor ,n,stats);
+                    if(stats) stats->reset();
+                }
+                if(end_test(config,sampler,t)) break;
+                sampler(e,config,t);
+                visitor.visit(config,sampler,t);
+                t = *(++schedule);
+            }
+            visitor.end(config,sampler,t);
+            //]
+        }
+    }
+
+    /**
+     * Runs the same process as optimize, with the same trajectory, but only calls
+     * the end test and the visitor at the iterations they declare interesting
+     * through the idle_iterations/skip_iterations hooks. Models that do not provide
+     * these hooks are called at each iteration.
+     */
+    //[chunked_optimize_signature
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest,
+            typename Visitor
+            >
+            void chunked_optimize(
+                    Engine& e,
+                    Configuration& config, Sampler& sampler,
+                    Schedule& schedule, EndTest& end_test,
+                    Visitor& visitor )
+            //]
+    {
+        internal::chunked_optimize(e,config,sampler,schedule,end_test,visitor,(kernel_statistics*)NULL);
+    }
+
+    /**
+     * Same as above, also accumulating the per-kernel statistics of the idle
+     * iterations in `stats`. They are handed to the visitor by skip_iterations
+     * and reset after each chunk.
+     */
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest,
+            typename Visitor
+            >
+            void chunked_optimize(
+                    Engine& e,
+                    Configuration& config, Sampler& sampler,
+                    Schedule& schedule, EndTest& end_test,
+                    Visitor& visitor, kernel_statistics& stats )
+    {
+        internal::chunked_optimize(e,config,sampler,schedule,end_test,visitor,&stats);
+    }
+}
+
+#endif // CHUNKED_OPTIMIZE_HPP
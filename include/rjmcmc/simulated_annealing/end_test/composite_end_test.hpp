@@ -38,6 +38,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #define COMPOSITE_END_TEST
 
 #include <rjmcmc/util/tuple.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
 
 namespace simulated_annealing
 {
@@ -79,6 +81,31 @@ namespace simulated_annealing
             rjmcmc::for_each(m_end_tests,pred);
             return pred.value();
         }
+
+        friend unsigned int idle_iterations(const composite_end_test& e)
+        {
+            internal::idle_iterations_min pred;
+            rjmcmc::for_each(const_cast<EndTests&>(e.m_end_tests),pred);
+            return pred.value();
+        }
+
+        friend void skip_iterations(composite_end_test& e, unsigned int n, const kernel_statistics *stats)
+        {
+            internal::skip_iterations_all pred(n,stats);
+            rjmcmc::for_each(e.m_end_tests,pred);
+        }
+
+        friend void save_state(std::ostream& os, const composite_end_test& e)
+        {
+            rjmcmc::internal::save_state_all f(os);
+            rjmcmc::for_each(const_cast<EndTests&>(e.m_end_tests),f);
+        }
+
+        friend void load_state(std::istream& is, composite_end_test& e)
+        {
+            rjmcmc::internal::load_state_all f(is);
+            rjmcmc::for_each(e.m_end_tests,f);
+        }
     private:
         EndTests m_end_tests;
     };
@@ -0,0 +1,194 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef CONVERGENCE_END_TEST_HPP
+#define CONVERGENCE_END_TEST_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "rjmcmc/util/checkpoint.hpp"
+
+namespace simulated_annealing
+{
+    /**
+     * \ingroup GroupEndTest
+     *
+     * This class is a model of the EndTest concept and stops
+     * the simulated annealing process once it has plateaued : over the last two sliding windows of `window` iterations,
+     * the mean energies and the mean object counts differ by at most `tolerance` relatively,
+     * and the acceptance rates of each kernel proposed in both windows differ by at most `acceptance_tolerance`.
+     * The window statistics are updated in constant time per iteration, from a buffer of the last `2*window` iterations.
+     * As hot stationary phases may also plateau, the windows should span a significant decrease of the temperature.
+     */
+    class convergence_end_test {
+    public:
+        convergence_end_test(unsigned int window, double tolerance, double acceptance_tolerance)
+            : m_window(window>0 ? window : 1), m_tolerance(tolerance), m_acceptance_tolerance(acceptance_tolerance)
+            , m_started(false), m_stop(false), m_head(0), m_count(0), m_kernel_size(0) {}
+
+        template<typename Configuration, typename Sampler>
+        inline bool operator()(const Configuration& c, const Sampler& s, double) {
+            if(m_stop) return true;
+            if(!m_started) { m_started = true; return false; } // no iteration to observe yet
+            if(!m_kernel_size) resize(s.kernel_size());
+            sample x = { c.energy(), static_cast<double>(c.size()), 2*s.kernel_id()+(s.accepted()?1:0) };
+            push(x);
+            return m_count==2*m_window && converged();
+        }
+        void stop () { m_stop=true; }
+
+        friend void save_state(std::ostream& os, const convergence_end_test& t) {
+            rjmcmc::write_binary(os,t.m_started);
+            rjmcmc::write_binary(os,t.m_stop);
+            rjmcmc::write_binary(os,t.m_kernel_size);
+            rjmcmc::write_binary(os,t.m_count);
+            for(unsigned int i=0; i<t.m_count; ++i) rjmcmc::write_binary(os,t.m_samples[t.index(i)]);
+        }
+        friend void load_state(std::istream& is, convergence_end_test& t) {
+            unsigned int kernel_size, count;
+            rjmcmc::read_binary(is,t.m_started);
+            rjmcmc::read_binary(is,t.m_stop);
+            rjmcmc::read_binary(is,kernel_size);
+            rjmcmc::read_binary(is,count);
+            t.m_kernel_size = 0;
+            t.m_count = t.m_head = 0;
+            if(kernel_size) t.resize(kernel_size);
+            for(unsigned int i=0; i<count; ++i)
+            {
+                sample x;
+                rjmcmc::read_binary(is,x);
+                t.push(x);
+            }
+        }
+
+    private:
+        struct sample
+        {
+            double energy;
+            double size;
+            unsigned int kernel; // 2*kernel_id+accepted
+        };
+
+        // running sums over a window
+        struct window
+        {
+            double energy, size;
+            std::vector<unsigned int> proposed, accepted;
+            void clear(unsigned int kernel_size)
+            {
+                energy = size = 0;
+                proposed.assign(kernel_size,0);
+                accepted.assign(kernel_size,0);
+            }
+            inline void add(const sample& x)
+            {
+                energy += x.energy; size += x.size;
+                ++proposed[x.kernel/2]; accepted[x.kernel/2] += x.kernel%2;
+            }
+            inline void remove(const sample& x)
+            {
+                energy -= x.energy; size -= x.size;
+                --proposed[x.kernel/2]; accepted[x.kernel/2] -= x.kernel%2;
+            }
+        };
+
+        void resize(unsigned int kernel_size)
+        {
+            m_kernel_size = kernel_size;
+            m_samples.resize(2*m_window);
+            m_recent.clear(kernel_size);
+            m_previous.clear(kernel_size);
+        }
+
+        // index in the circular buffer of the i-th oldest sample
+        inline unsigned int index(unsigned int i) const { return (m_head+2*m_window-m_count+i)%(2*m_window); }
+
+        void push(const sample& x)
+        {
+            if(m_count==2*m_window) m_previous.remove(m_samples[m_head]);
+            if(m_count>=m_window)
+            {
+                const sample& y = m_samples[(m_head+m_window)%(2*m_window)];
+                m_recent.remove(y);
+                m_previous.add(y);
+            }
+            m_samples[m_head] = x;
+            m_recent.add(x);
+            m_head = (m_head+1)%(2*m_window);
+            if(m_count<2*m_window) ++m_count;
+            else if(m_head==0) resum(); // cancels the rounding errors accumulated by the running energy sums
+        }
+
+        void resum()
+        {
+            m_recent.energy = m_previous.energy = 0;
+            for(unsigned int i=0; i<m_window; ++i)
+            {
+                m_previous.energy += m_samples[i].energy;
+                m_recent  .energy += m_samples[m_window+i].energy;
+            }
+        }
+
+        inline bool close(double a, double b) const { return std::abs(a-b) <= m_tolerance*(std::max)(std::abs(a),std::abs(b)); }
+
+        bool converged() const
+        {
+            if(!close(m_recent.energy,m_previous.energy) || !close(m_recent.size,m_previous.size)) return false;
+            for(unsigned int k=0; k<m_kernel_size; ++k)
+            {
+                if(!m_recent.proposed[k] || !m_previous.proposed[k]) continue;
+                double r = double(m_recent  .accepted[k])/m_recent  .proposed[k];
+                double p = double(m_previous.accepted[k])/m_previous.proposed[k];
+                if(std::abs(r-p)>m_acceptance_tolerance) return false;
+            }
+            return true;
+        }
+
+        unsigned int m_window;
+        double m_tolerance, m_acceptance_tolerance;
+        bool m_started, m_stop;
+        std::vector<sample> m_samples; // circular buffer of the last 2*m_window samples
+        unsigned int m_head;           // next slot to be written
+        unsigned int m_count;
+        unsigned int m_kernel_size;
+        window m_recent, m_previous;
+    };
+
+};
+
+#endif // CONVERGENCE_END_TEST_HPP
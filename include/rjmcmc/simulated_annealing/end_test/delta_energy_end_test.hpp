@@ -37,6 +37,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef DELTA_ENERGY_END_TEST
 #define DELTA_ENERGY_END_TEST
 
+#include "rjmcmc/util/checkpoint.hpp"
+
 namespace simulated_annealing
 {
     /**
@@ -56,6 +58,9 @@ namespace simulated_annealing
             return m_i>=m_n;
         }
         void stop () { m_n=0; }
+
+        friend void save_state(std::ostream& os, const delta_energy_end_test& t) { rjmcmc::write_binary(os,t.m_i); }
+        friend void load_state(std::istream& is, delta_energy_end_test& t) { rjmcmc::read_binary(is,t.m_i); }
     private:
         unsigned int m_i, m_n;
     };
@@ -37,6 +37,9 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef MAX_ITERATION_END_TEST
 #define MAX_ITERATION_END_TEST
 
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
 namespace simulated_annealing
 {
     /**
@@ -54,6 +57,16 @@ namespace simulated_annealing
             return ((--m_iterations)<=0);
         }
         void stop () { m_iterations=0; }
+
+        friend inline unsigned int idle_iterations(const max_iteration_end_test& t) {
+            return t.m_iterations>1 ? t.m_iterations-1 : 0;
+        }
+        friend inline void skip_iterations(max_iteration_end_test& t, unsigned int n, const kernel_statistics *) {
+            t.m_iterations -= n;
+        }
+
+        friend void save_state(std::ostream& os, const max_iteration_end_test& t) { rjmcmc::write_binary(os,t.m_iterations); }
+        friend void load_state(std::istream& is, max_iteration_end_test& t) { rjmcmc::read_binary(is,t.m_iterations); }
     private:
         int m_iterations;
     };
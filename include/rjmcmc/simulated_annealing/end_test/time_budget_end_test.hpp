@@ -0,0 +1,85 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef TIME_BUDGET_END_TEST_HPP
+#define TIME_BUDGET_END_TEST_HPP
+
+#include "rjmcmc/util/throughput_clock.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
+namespace simulated_annealing
+{
+    /**
+     * \ingroup GroupEndTest
+     *
+     * This class is a model of the EndTest concept and stops
+     * the simulated annealing process once `seconds` of wall clock time have elapsed since its first call.
+     * The clock is only read about every `period` seconds, so the deadline may be overrun by about this period.
+     * As every iteration leaves a valid configuration, the process may be stopped at any time ;
+     * a best_visitor restores the best configuration visited before the deadline.
+     */
+    class time_budget_end_test {
+    public:
+        time_budget_end_test(double seconds, double period = 1e-3) : m_budget(seconds), m_clock(period) {}
+        template<typename Configuration, typename Sampler>
+        inline bool operator()(const Configuration&, const Sampler&, double) {
+            return m_clock.tick() && m_clock.elapsed()>=m_budget;
+        }
+        void stop () { m_budget=0; }
+
+        inline double budget   () const { return m_budget; }
+        inline double elapsed  () const { return m_clock.elapsed(); }
+        inline double remaining() const { return m_budget>m_clock.elapsed() ? m_budget-m_clock.elapsed() : 0; }
+
+        friend inline unsigned int idle_iterations(const time_budget_end_test& t) {
+            return t.m_clock.idle_ticks();
+        }
+        friend inline void skip_iterations(time_budget_end_test& t, unsigned int n, const kernel_statistics *) {
+            t.m_clock.skip(n);
+        }
+
+        // the elapsed time, so that a resumed optimization gets the rest of the budget
+        friend void save_state(std::ostream& os, const time_budget_end_test& t) { save_state(os,t.m_clock); }
+        friend void load_state(std::istream& is, time_budget_end_test& t) { load_state(is,t.m_clock); }
+    private:
+        double m_budget;
+        rjmcmc::throughput_clock m_clock;
+    };
+
+};
+
+#endif // TIME_BUDGET_END_TEST_HPP
@@ -0,0 +1,83 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef KERNEL_STATISTICS_HPP
+#define KERNEL_STATISTICS_HPP
+
+#include <limits>
+#include <algorithm>
+#include "rjmcmc/rjmcmc/sampler/kernel_statistics.hpp"
+
+namespace simulated_annealing
+{
+    using rjmcmc::kernel_statistics;
+
+    //[chunked_optimize_hooks
+    /// number of upcoming iterations during which `t` does not need to be called (default : none)
+    template<typename T>
+    inline unsigned int idle_iterations(const T&) { return 0; }
+
+    /// notifies `t` that `n` idle iterations were performed without calling it
+    template<typename T>
+    inline void skip_iterations(T&, unsigned int, const kernel_statistics *) {}
+    //]
+
+    namespace internal
+    {
+        // hooks of composite models : the minimum over their elements, forwarded to each element
+        struct idle_iterations_min
+        {
+            unsigned int m_value;
+            idle_iterations_min() : m_value((std::numeric_limits<unsigned int>::max)()) {}
+            unsigned int value() const { return m_value; }
+            template<typename T> inline void operator()(T& t) { m_value = (std::min)(m_value,idle_iterations(t)); }
+            template<typename T> inline void operator()(T* t) { operator()(*t); }
+        };
+
+        struct skip_iterations_all
+        {
+            unsigned int m_n;
+            const kernel_statistics *m_stats;
+            skip_iterations_all(unsigned int n, const kernel_statistics *stats) : m_n(n), m_stats(stats) {}
+            template<typename T> inline void operator()(T& t) { skip_iterations(t,m_n,m_stats); }
+            template<typename T> inline void operator()(T* t) { operator()(*t); }
+        };
+    }
+
+}; // namespace simulated_annealing
+
+#endif // KERNEL_STATISTICS_HPP
@@ -0,0 +1,191 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef MULTI_CHAIN_HPP
+#define MULTI_CHAIN_HPP
+
+#include <vector>
+#include <limits>
+#include <boost/concept_check.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include "rjmcmc/util/random.hpp"
+
+namespace simulated_annealing
+{
+    /// per-chain outcome of multi_chain_optimize
+    struct chain_statistics
+    {
+        unsigned int iterations;
+        double energy;
+        bool killed; // stopped at a checkpoint by the racing strategy
+        chain_statistics() : iterations(0), energy(0), killed(false) {}
+    };
+
+    namespace internal
+    {
+        template<typename Engine, typename Configuration, typename Sampler, typename Schedule, typename EndTest>
+        class multi_chain_runner
+        {
+        public:
+            multi_chain_runner(Engine& e, const Configuration& config, const Sampler& sampler,
+                               const Schedule& schedule, const EndTest& end_test,
+                               unsigned int chains, unsigned int checkpoint, double margin)
+                : m_config(config), m_sampler(sampler), m_schedule(schedule), m_end_test(end_test)
+                , m_checkpoint(checkpoint), m_margin(margin), m_next(0), m_best(NULL), m_stats(chains)
+            {
+                for(unsigned int i=0; i<chains; ++i) m_engines.push_back(rjmcmc::split_stream(e,rjmcmc::chain_stream));
+            }
+
+            ~multi_chain_runner() { delete m_best; }
+
+            // thread body : runs the chains that are not yet started, one at a time
+            void work()
+            {
+                for(;;)
+                {
+                    unsigned int i;
+                    {
+                        boost::mutex::scoped_lock lock(m_mutex);
+                        if(m_next==m_stats.size()) return;
+                        i = m_next++;
+                    }
+                    run(i);
+                }
+            }
+
+            inline const Configuration* best() const { return m_best; }
+            inline const std::vector<chain_statistics>& statistics() const { return m_stats; }
+
+        private:
+            void run(unsigned int i)
+            {
+                Engine& e = m_engines[i];
+                Sampler sampler(m_sampler);
+                Schedule schedule(m_schedule);
+                EndTest end_test(m_end_test);
+                Configuration *c = new Configuration(m_config);
+                unsigned int iter = 0;
+                bool killed = false;
+                for(double t = *schedule; !end_test(*c,sampler,t); t = *(++schedule))
+                {
+                    sampler(e,*c,t);
+                    ++iter;
+                    if(m_checkpoint && iter%m_checkpoint==0 && (killed = !report(iter/m_checkpoint-1,c->energy())))
+                        break;
+                }
+
+                boost::mutex::scoped_lock lock(m_mutex);
+                chain_statistics& s = m_stats[i];
+                s.iterations = iter;
+                s.energy = c->energy();
+                s.killed = killed;
+                if(!m_best || s.energy<m_best->energy()) std::swap(m_best,c);
+                delete c;
+            }
+
+            // records the energy of a chain at the given checkpoint and returns whether the chain is still in the race
+            bool report(unsigned int checkpoint, double energy)
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if(checkpoint>=m_checkpoints.size())
+                    m_checkpoints.resize(checkpoint+1,std::numeric_limits<double>::infinity());
+                double& best = m_checkpoints[checkpoint];
+                if(energy<best) best = energy;
+                return energy<=best+m_margin;
+            }
+
+            const Configuration& m_config;
+            const Sampler& m_sampler;
+            const Schedule& m_schedule;
+            const EndTest& m_end_test;
+            unsigned int m_checkpoint;
+            double m_margin;
+
+            boost::mutex m_mutex;
+            unsigned int m_next;
+            std::vector<Engine> m_engines;
+            std::vector<double> m_checkpoints; // best energy reached at each checkpoint
+            Configuration *m_best;
+            std::vector<chain_statistics> m_stats;
+        };
+    }
+
+    /**
+     * \ingroup GroupSimulatedAnnealing
+     *
+     * Runs `chains` independent simulated annealing chains on a pool of `threads` threads
+     * (0 uses the number of hardware threads) and replaces `config` with the final configuration of lowest energy.
+     * Each chain starts from a copy of `config`, `sampler`, `schedule` and `end_test`, with its own engine stream split from `e` at the chain_stream level.
+     * Every `checkpoint` iterations (0 disables racing), a chain whose energy exceeds by more than `margin`
+     * the lowest energy reached so far at the same checkpoint by any chain is stopped,
+     * freeing its thread for the remaining chains.
+     * As chains run concurrently, racing decisions depend on thread scheduling.
+     */
+    //[multi_chain_optimize_signature
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest
+            >
+            std::vector<chain_statistics> multi_chain_optimize(
+                    Engine& e,
+                    Configuration& config, const Sampler& sampler,
+                    const Schedule& schedule, const EndTest& end_test,
+                    unsigned int chains, unsigned int threads = 0,
+                    unsigned int checkpoint = 0, double margin = std::numeric_limits<double>::infinity() )
+            //]
+    {
+        BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+        typedef internal::multi_chain_runner<Engine,Configuration,Sampler,Schedule,EndTest> runner_type;
+        runner_type runner(e,config,sampler,schedule,end_test,chains,checkpoint,margin);
+
+        if(!threads) threads = boost::thread::hardware_concurrency();
+        if(threads>chains) threads = chains;
+        boost::thread_group pool;
+        for(unsigned int i=1; i<threads; ++i)
+            pool.create_thread(boost::bind(&runner_type::work,&runner));
+        runner.work();
+        pool.join_all();
+
+        if(runner.best()) config = *runner.best();
+        return runner.statistics();
+    }
+}
+
+#endif // MULTI_CHAIN_HPP
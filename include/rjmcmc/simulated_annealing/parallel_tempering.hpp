@@ -0,0 +1,206 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef PARALLEL_TEMPERING_HPP
+#define PARALLEL_TEMPERING_HPP
+
+#include <vector>
+#include <cmath>
+#include <boost/concept_check.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include "rjmcmc/util/random.hpp"
+
+namespace simulated_annealing
+{
+    namespace parallel_tempering
+    {
+
+        namespace internal
+        {
+            // a replica of the chain, running at a fixed multiple of the temperature provided by its own copy of the schedule
+            template<typename Engine, typename Configuration, typename Sampler, typename Schedule>
+            struct replica
+            {
+                Engine         m_engine;
+                Sampler        m_sampler;
+                Schedule       m_schedule;
+                Configuration *m_config;
+                double         m_factor;
+
+                replica(const Engine& e, const Sampler& s, const Schedule& sch, Configuration *c, double factor)
+                    : m_engine(e), m_sampler(s), m_schedule(sch), m_config(c), m_factor(factor) {}
+
+                inline double temperature() const { return m_factor*(*m_schedule); }
+
+                void run(unsigned int n)
+                {
+                    for(unsigned int i=0; i<n; ++i, ++m_schedule)
+                        m_sampler(m_engine,*m_config,temperature());
+                }
+            };
+
+            // runs blocks of n iterations of a replica, synchronized with the driver thread through a barrier
+            template<typename Replica>
+            struct worker
+            {
+                Replica& m_replica;
+                boost::barrier& m_barrier;
+                const bool& m_quit;
+                unsigned int m_n;
+
+                worker(Replica& r, boost::barrier& b, const bool& quit, unsigned int n)
+                    : m_replica(r), m_barrier(b), m_quit(quit), m_n(n) {}
+
+                void operator()()
+                {
+                    for(;;)
+                    {
+                        m_barrier.wait(); // block start
+                        if(m_quit) return;
+                        m_replica.run(m_n);
+                        m_barrier.wait(); // block end
+                    }
+                }
+            };
+
+            // Metropolis exchange rule between two replicas at temperatures t0 and t1
+            template<typename Engine, typename Configuration>
+            inline bool exchange(Engine& e, const Configuration& c0, double t0, const Configuration& c1, double t1)
+            {
+                double r = (c0.energy()-c1.energy())*(1./t0-1./t1);
+                if(r>=0) return true;
+                boost::uniform_real<> rand(0,1);
+                return rand(e) < std::exp(r);
+            }
+        }
+
+        /**
+         * \ingroup GroupSimulatedAnnealing
+         *
+         * Replica-exchange (parallel tempering) variant of simulated_annealing::optimize.
+         * `replicas` copies of the configuration are sampled concurrently, one thread each, at the temperatures
+         * \f$T_k=\rho^k T\f$ where \f$T\f$ is the current temperature of the schedule and \f$\rho\f$ is the `ratio` of the ladder.
+         * Every `exchange` iterations, adjacent replicas are swapped with the Metropolis exchange probability
+         * \f$\min\left(1,\exp\left((E_k-E_{k+1})(1/T_k-1/T_{k+1})\right)\right)\f$.
+         * The end test and the visitor only observe the coldest replica, which is copied back into `config` at the end.
+         * Each hotter replica gets a copy of the sampler and of the schedule and its own engine stream, split from `e` by rjmcmc::split_stream at the chain_stream level.
+         */
+        //[parallel_tempering_signature
+        template<
+                typename Engine,
+                typename Configuration, typename Sampler,
+                typename Schedule, typename EndTest,
+                typename Visitor
+                >
+                void optimize(
+                        Engine& e,
+                        Configuration& config, Sampler& sampler,
+                        Schedule& schedule, EndTest& end_test,
+                        Visitor& visitor,
+                        unsigned int replicas, double ratio, unsigned int exchange )
+                //]
+        {
+            BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+            typedef internal::replica<Engine,Configuration,Sampler,Schedule> replica;
+            typedef internal::worker<replica> worker;
+
+            if(replicas<1) replicas = 1;
+            if(exchange<1) exchange = 1;
+
+            // the coldest rung of the ladder is driven in place, by the calling thread
+            std::vector<Configuration*> configs(replicas,&config);
+            std::vector<replica*> hot;
+            double factor = 1.;
+            for(unsigned int k=1; k<replicas; ++k)
+            {
+                factor *= ratio;
+                configs[k] = new Configuration(config);
+                hot.push_back(new replica(rjmcmc::split_stream(e,rjmcmc::chain_stream),sampler,schedule,configs[k],factor));
+            }
+
+            bool quit = false;
+            boost::barrier barrier(replicas);
+            boost::thread_group threads;
+            for(unsigned int k=1; k<replicas; ++k)
+                threads.create_thread(worker(*hot[k-1],barrier,quit,exchange));
+
+            double t = *schedule;
+            unsigned int parity = 0;
+            visitor.begin(config,sampler,t);
+            for(bool done=false; !done; parity^=1)
+            {
+                barrier.wait(); // block start
+                Configuration& c = *configs[0];
+                for(unsigned int i=0; i<exchange; ++i, t = *(++schedule))
+                {
+                    if((done = end_test(c,sampler,t))) break;
+                    sampler(e,c,t);
+                    visitor.visit(c,sampler,t);
+                }
+                barrier.wait(); // block end
+                if(done) break;
+
+                // replica exchanges between adjacent rungs, alternating between even and odd pairs
+                for(unsigned int k=parity; k+1<replicas; k+=2)
+                {
+                    double t0 = (k==0) ? t : hot[k-1]->temperature();
+                    double t1 = hot[k]->temperature();
+                    if(!internal::exchange(e,*configs[k],t0,*configs[k+1],t1)) continue;
+                    std::swap(configs[k],configs[k+1]);
+                    hot[k]->m_config = configs[k+1];
+                    if(k>0) hot[k-1]->m_config = configs[k];
+                }
+            }
+            quit = true;
+            barrier.wait();
+            threads.join_all();
+
+            if(configs[0]!=&config) config = *configs[0];
+            visitor.end(config,sampler,t);
+
+            for(unsigned int k=0; k<replicas; ++k)
+                if(configs[k]!=&config) delete configs[k];
+            for(unsigned int k=0; k<hot.size(); ++k)
+                delete hot[k];
+        }
+
+    } // namespace parallel_tempering
+}
+
+#endif // PARALLEL_TEMPERING_HPP
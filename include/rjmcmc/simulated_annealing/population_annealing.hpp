@@ -0,0 +1,319 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef POPULATION_ANNEALING_HPP
+#define POPULATION_ANNEALING_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <boost/concept_check.hpp>
+#include <boost/bind.hpp>
+#include <boost/random/uniform_real.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/mutex.hpp>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
+namespace simulated_annealing
+{
+    namespace population_annealing
+    {
+        /// outcome of population_annealing::optimize
+        struct population_statistics
+        {
+            unsigned int steps; // number of temperature steps, each followed by a resampling
+            unsigned int copies; // number of configuration copies made by the resamplings
+            // estimate of \f$\log(Z(T_n)/Z(T_0))\f$ between the initial and the final temperatures,
+            // that is of \f$\beta_0F_0-\beta_nF_n\f$ for the free energies \f$F=-T\log Z\f$
+            double log_partition_ratio;
+            population_statistics() : steps(0), copies(0), log_partition_ratio(0) {}
+        };
+
+        namespace internal
+        {
+            // the replicas of the population, sampled concurrently by blocks of iterations at a fixed temperature
+            template<typename Engine, typename Configuration, typename Sampler>
+            class population
+            {
+            public:
+                population(Engine& e, const Configuration& config, const Sampler& sampler, unsigned int replicas)
+                    : m_next(0), m_temperature(0), m_iterations(0)
+                {
+                    for(unsigned int i=0; i<replicas; ++i)
+                    {
+                        m_engines .push_back(rjmcmc::split_stream(e,rjmcmc::chain_stream));
+                        m_samplers.push_back(sampler);
+                        m_configs .push_back(new Configuration(config));
+                    }
+                    m_stats.resize(replicas);
+                    for(unsigned int i=0; i<replicas; ++i) m_stats[i].begin(m_samplers[i]);
+                }
+
+                ~population()
+                {
+                    for(unsigned int i=0; i<m_configs.size(); ++i) delete m_configs[i];
+                }
+
+                inline unsigned int size() const { return m_configs.size(); }
+                inline Configuration& config(unsigned int i) { return *m_configs[i]; }
+                inline Sampler& sampler(unsigned int i) { return m_samplers[i]; }
+                inline const kernel_statistics& statistics(unsigned int i) const { return m_stats[i]; }
+
+                void reset_statistics()
+                {
+                    for(unsigned int i=0; i<m_stats.size(); ++i) m_stats[i].reset();
+                }
+
+                unsigned int best() const
+                {
+                    unsigned int b = 0;
+                    for(unsigned int i=1; i<m_configs.size(); ++i)
+                        if(m_configs[i]->energy()<m_configs[b]->energy()) b = i;
+                    return b;
+                }
+
+                // prepares a block of n iterations at temperature t, before the workers are released
+                void prepare(double t, unsigned int n)
+                {
+                    m_next = 0;
+                    m_temperature = t;
+                    m_iterations = n;
+                }
+
+                // samples the replicas that are not yet processed in the current block, one at a time
+                void work()
+                {
+                    for(;;)
+                    {
+                        unsigned int i;
+                        {
+                            boost::mutex::scoped_lock lock(m_mutex);
+                            if(m_next==m_configs.size()) return;
+                            i = m_next++;
+                        }
+                        for(unsigned int k=0; k<m_iterations; ++k)
+                        {
+                            m_samplers[i](m_engines[i],*m_configs[i],m_temperature);
+                            m_stats[i](m_samplers[i]);
+                        }
+                    }
+                }
+
+                /*
+                 * Reweights the replicas by \f$\exp(-(1/t_1-1/t_0)E_i)\f$ and resamples them systematically,
+                 * returning the log of the mean weight. Surviving replicas are kept in place and
+                 * the slots of the extinct ones are overwritten by copies of the replicas drawn several times.
+                 */
+                template<typename E>
+                double resample(E& e, double t0, double t1, unsigned int& copies)
+                {
+                    const unsigned int n = m_configs.size();
+                    const double dbeta = 1./t1-1./t0;
+                    std::vector<double> w(n);
+                    double wmax = -dbeta*m_configs[0]->energy();
+                    for(unsigned int i=0; i<n; ++i)
+                    {
+                        w[i] = -dbeta*m_configs[i]->energy();
+                        if(w[i]>wmax) wmax = w[i];
+                    }
+                    double sum = 0;
+                    for(unsigned int i=0; i<n; ++i) sum += (w[i] = std::exp(w[i]-wmax));
+
+                    boost::uniform_real<> rand(0,1);
+                    double u = rand(e), c = 0;
+                    std::vector<unsigned int> offspring(n);
+                    std::vector<unsigned int> extinct;
+                    for(unsigned int i=0, prev=0; i<n; ++i)
+                    {
+                        c += n*w[i]/sum;
+                        unsigned int next = (i+1==n) ? n : (std::min)(n,(unsigned int)(c+u));
+                        offspring[i] = next-prev;
+                        prev = next;
+                        if(!offspring[i]) extinct.push_back(i);
+                    }
+                    for(unsigned int i=0; i<n; ++i)
+                        for(unsigned int k=1; k<offspring[i]; ++k, ++copies)
+                        {
+                            *m_configs[extinct.back()] = *m_configs[i];
+                            extinct.pop_back();
+                        }
+                    return wmax+std::log(sum/n);
+                }
+
+            private:
+                boost::mutex m_mutex;
+                unsigned int m_next;
+                double m_temperature;
+                unsigned int m_iterations;
+                std::vector<Engine> m_engines;
+                std::vector<Sampler> m_samplers;
+                std::vector<Configuration*> m_configs;
+                std::vector<kernel_statistics> m_stats; // per-kernel counts of each replica since the latest reset_statistics()
+            };
+
+            // runs n iterations of all the replicas at temperature t, the calling thread taking part in the work
+            template<typename Population>
+            void run_block(Population& pop, boost::barrier& barrier, double t, unsigned int n)
+            {
+                pop.prepare(t,n);
+                barrier.wait(); // block start
+                pop.work();
+                barrier.wait(); // block end
+            }
+
+            // runs the blocks of a population, synchronized with the driver thread through a barrier
+            template<typename Population>
+            struct worker
+            {
+                Population& m_population;
+                boost::barrier& m_barrier;
+                const bool& m_quit;
+
+                worker(Population& p, boost::barrier& b, const bool& quit)
+                    : m_population(p), m_barrier(b), m_quit(quit) {}
+
+                void operator()()
+                {
+                    for(;;)
+                    {
+                        m_barrier.wait(); // block start
+                        if(m_quit) return;
+                        m_population.work();
+                        m_barrier.wait(); // block end
+                    }
+                }
+            };
+        }
+
+        /**
+         * \ingroup GroupSimulatedAnnealing
+         *
+         * Population annealing variant of simulated_annealing::optimize.
+         * `replicas` copies of the configuration are sampled on a pool of `threads` threads (0 uses the number of hardware threads)
+         * by blocks of `sweeps` iterations, each block running at the temperature reached by the schedule at its start.
+         * Between two blocks, the schedule is advanced by `sweeps` steps from \f$T\f$ to \f$T'\f$ and the population is
+         * reweighted by \f$\exp(-(1/T'-1/T)E_i)\f$ and resampled systematically, so that low-energy replicas are duplicated
+         * and high-energy ones die out.
+         * The end test and the visitor observe the lowest-energy replica at the iterations they declare interesting through
+         * idle_iterations, the blocks being split there. The other iterations are reported to them through skip_iterations,
+         * with the per-kernel statistics of the observed replica. This replica is copied back into `config` at the end.
+         * Each replica gets a copy of the sampler and its own engine stream, split from `e` by rjmcmc::split_stream at the chain_stream level.
+         * The log of the mean weights accumulates into an estimate of the free energy difference between the initial and final temperatures.
+         */
+        //[population_annealing_signature
+        template<
+                typename Engine,
+                typename Configuration, typename Sampler,
+                typename Schedule, typename EndTest,
+                typename Visitor
+                >
+                population_statistics optimize(
+                        Engine& e,
+                        Configuration& config, const Sampler& sampler,
+                        Schedule& schedule, EndTest& end_test,
+                        Visitor& visitor,
+                        unsigned int replicas, unsigned int sweeps, unsigned int threads = 0 )
+                //]
+        {
+            BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+            typedef internal::population<Engine,Configuration,Sampler> population;
+            typedef internal::worker<population> worker;
+
+            if(replicas<1) replicas = 1;
+            if(sweeps<1) sweeps = 1;
+            if(!threads) threads = boost::thread::hardware_concurrency();
+            if(threads>replicas) threads = replicas;
+            if(threads<1) threads = 1;
+
+            population pop(e,config,sampler,replicas);
+            bool quit = false;
+            boost::barrier barrier(threads);
+            boost::thread_group pool;
+            for(unsigned int k=1; k<threads; ++k)
+                pool.create_thread(worker(pop,barrier,quit));
+
+            population_statistics stats;
+            double t = *schedule;
+            unsigned int best = 0;
+            bool stop = false;
+            visitor.begin(config,sampler,t);
+            for(;;)
+            {
+                for(unsigned int done=0; done<sweeps; )
+                {
+                    unsigned int n = (std::min)(sweeps-done,(std::min)(idle_iterations(end_test),idle_iterations(visitor)));
+                    if(n)
+                    {
+                        internal::run_block(pop,barrier,t,n);
+                        best = pop.best();
+                        skip_iterations(end_test,n,&pop.statistics(best));
+                        skip_iterations(visitor ,n,&pop.statistics(best));
+                        pop.reset_statistics();
+                        done += n;
+                        continue;
+                    }
+                    if((stop = end_test(pop.config(best),pop.sampler(best),t))) break;
+                    internal::run_block(pop,barrier,t,1);
+                    best = pop.best();
+                    visitor.visit(pop.config(best),pop.sampler(best),t);
+                    pop.reset_statistics();
+                    ++done;
+                }
+                if(stop) break;
+
+                double t0 = t;
+                for(unsigned int i=0; i<sweeps; ++i) t = *(++schedule);
+                stats.log_partition_ratio += pop.resample(e,t0,t,stats.copies);
+                ++stats.steps;
+                best = pop.best();
+            }
+            quit = true;
+            barrier.wait();
+            pool.join_all();
+
+            config = pop.config(best);
+            visitor.end(config,pop.sampler(best),t);
+            return stats;
+        }
+
+    } // namespace population_annealing
+}
+
+#endif // POPULATION_ANNEALING_HPP
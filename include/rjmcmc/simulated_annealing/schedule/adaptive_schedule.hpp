@@ -0,0 +1,148 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef ADAPTIVE_SCHEDULE_HPP
+#define ADAPTIVE_SCHEDULE_HPP
+
+#include <cmath>
+#include <iterator>
+#include "rjmcmc/util/checkpoint.hpp"
+
+namespace simulated_annealing {
+    /**
+     * \ingroup GroupSchedule
+     *
+     * This class is a model of the Schedule concept and implements the adaptive schedule of Lam and Delosme,
+     * which cools fast while the energy fluctuates little and slowly near phase transitions, where its variance peaks.
+     * At each iteration, the inverse temperature \f$s=1/T\f$ is increased by
+     * \f[\Delta s=\frac{\lambda}{\sigma}\frac{1}{s^2\sigma^2}\frac{4\rho(1-\rho)^2}{(2-\rho)^2}\f]
+     * where \f$\sigma\f$ is the standard deviation of the energy and \f$\rho\f$ the acceptance rate, both estimated
+     * over about the last `window` iterations, and \f$\lambda\f$ is a quality factor (smaller values cool more slowly).
+     * The resulting decrease coefficient is clamped to [`alpha_min`,`alpha_max`] and the temperature is held
+     * until the first `window` iterations are observed.
+     *
+     * The sampler outcomes are fed through the feedback hook, which a feedback_visitor calls after each iteration.
+     */
+    template<typename T>
+    class adaptive_schedule {
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T                       value_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef value_type*             pointer;
+        typedef value_type&             reference;
+
+        bool operator==(const adaptive_schedule<T>& s) const { return (m_temp==s.m_temp) && (m_alpha==s.m_alpha); }
+        bool operator!=(const adaptive_schedule<T>& s) const { return !(*this==s); }
+
+        /// @param temp Initial temperature
+        /// @param lambda Quality factor
+        /// @param window Number of iterations of the energy and acceptance statistics
+        /// @param alpha_min Lowest decrease coefficient
+        /// @param alpha_max Highest decrease coefficient
+        adaptive_schedule(value_type temp, double lambda, unsigned int window = 10000,
+                          value_type alpha_min = 0.999, value_type alpha_max = 1)
+            : m_temp(temp), m_alpha(1), m_lambda(lambda), m_window(window>0 ? window : 1)
+            , m_alpha_min(alpha_min), m_alpha_max(alpha_max)
+            , m_n(0), m_energy(0), m_mean(0), m_variance(0), m_acceptance(0) {}
+
+        inline value_type  operator*() const { return m_temp; }
+        inline adaptive_schedule<T>& operator++()    { m_temp *= m_alpha; return *this; }
+        inline adaptive_schedule<T>  operator++(int) { adaptive_schedule<T> t(*this); m_temp *= m_alpha; return t; }
+
+        inline value_type alpha() const { return m_alpha; }
+        inline double acceptance() const { return m_acceptance; }
+        inline double deviation() const { return std::sqrt(m_variance); }
+
+        /// records the outcome of the latest iteration and updates the decrease coefficient
+        void observe(bool accepted, double delta)
+        {
+            if(accepted) m_energy += delta; // energy relative to the initial one, which does not affect its variance
+            if(m_n<m_window) ++m_n;
+            double w = 1./m_n, d = m_energy-m_mean;
+            m_mean += w*d;
+            m_variance = (1-w)*(m_variance+w*d*d);
+            m_acceptance += w*((accepted?1.:0.)-m_acceptance);
+            if(m_n<m_window) return;
+
+            double s = 1./m_temp, sigma = std::sqrt(m_variance), rho = m_acceptance;
+            if(sigma<=0) { m_alpha = m_alpha_min; return; }
+            double ds = m_lambda/(sigma*s*s*sigma*sigma) * 4*rho*(1-rho)*(1-rho)/((2-rho)*(2-rho));
+            m_alpha = s/(s+ds);
+            if(m_alpha<m_alpha_min) m_alpha = m_alpha_min;
+            if(m_alpha>m_alpha_max) m_alpha = m_alpha_max;
+        }
+
+        template<typename Sampler>
+        friend inline void feedback(adaptive_schedule& s, const Sampler& sampler) { s.observe(sampler.accepted(),sampler.delta()); }
+
+        friend void save_state(std::ostream& os, const adaptive_schedule& s) {
+            rjmcmc::write_binary(os,s.m_temp);
+            rjmcmc::write_binary(os,s.m_alpha);
+            rjmcmc::write_binary(os,s.m_n);
+            rjmcmc::write_binary(os,s.m_energy);
+            rjmcmc::write_binary(os,s.m_mean);
+            rjmcmc::write_binary(os,s.m_variance);
+            rjmcmc::write_binary(os,s.m_acceptance);
+        }
+        friend void load_state(std::istream& is, adaptive_schedule& s) {
+            rjmcmc::read_binary(is,s.m_temp);
+            rjmcmc::read_binary(is,s.m_alpha);
+            rjmcmc::read_binary(is,s.m_n);
+            rjmcmc::read_binary(is,s.m_energy);
+            rjmcmc::read_binary(is,s.m_mean);
+            rjmcmc::read_binary(is,s.m_variance);
+            rjmcmc::read_binary(is,s.m_acceptance);
+        }
+
+    private:
+        // Current temperature
+        value_type m_temp;
+        // Current decrease coefficient
+        value_type m_alpha;
+        double m_lambda;
+        unsigned int m_window;
+        value_type m_alpha_min, m_alpha_max;
+        // exponentially weighted statistics over about the last m_window iterations
+        unsigned int m_n;
+        double m_energy, m_mean, m_variance, m_acceptance;
+    };
+
+}; // namespace simulated_annealing
+
+#endif // ADAPTIVE_SCHEDULE_HPP
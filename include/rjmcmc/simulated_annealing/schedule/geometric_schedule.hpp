@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define GEOMETRIC_SCHEDULE_HPP
 
 #include <iterator>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace simulated_annealing {
     /**
@@ -72,6 +73,9 @@ namespace simulated_annealing {
         inline value_type alpha() const { return m_alpha; }
         inline void alpha(value_type a) { m_alpha = a; }
 
+        friend void save_state(std::ostream& os, const geometric_schedule& s) { rjmcmc::write_binary(os,s.m_temp); }
+        friend void load_state(std::istream& is, geometric_schedule& s) { rjmcmc::read_binary(is,s.m_temp); }
+
     private:
         // Current temperature
         value_type m_temp;
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define INVERSE_LINEAR_SCHEDULE_HPP
 
 #include <iterator>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace simulated_annealing {
     /**
@@ -70,6 +71,9 @@ namespace simulated_annealing {
             return t;
         }
 
+        friend void save_state(std::ostream& os, const inverse_linear_schedule& s) { rjmcmc::write_binary(os,s.m_temp); }
+        friend void load_state(std::istream& is, inverse_linear_schedule& s) { rjmcmc::read_binary(is,s.m_temp); }
+
     private:
         // Current temperature
         value_type m_temp;
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define LOGARITHMIC_SCHEDULE_HPP
 
 #include <iterator>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace simulated_annealing {
     /**
@@ -67,6 +68,9 @@ namespace simulated_annealing {
         inline logarithmic_schedule<T>& operator++()    { ++m_n; return *this; }
         inline logarithmic_schedule<T>  operator++(int) { logarithmic_schedule t(*this); ++m_n; return t; }
 
+        friend void save_state(std::ostream& os, const logarithmic_schedule& s) { rjmcmc::write_binary(os,s.m_n); }
+        friend void load_state(std::istream& is, logarithmic_schedule& s) { rjmcmc::read_binary(is,s.m_n); }
+
     private:
         // Initial temperature
         value_type m_temp;
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define STEP_SCHEDULE_HPP
 
 #include <iterator>
+#include "rjmcmc/util/checkpoint.hpp"
 
 namespace simulated_annealing {
     /**
@@ -77,6 +78,19 @@ namespace simulated_annealing {
             return t;
         }
 
+        friend void save_state(std::ostream& os, const step_schedule& s) {
+            using rjmcmc::save_state;
+            save_state(os,s.m_schedule);
+            rjmcmc::write_binary(os,s.m_t);
+            rjmcmc::write_binary(os,s.m_i);
+        }
+        friend void load_state(std::istream& is, step_schedule& s) {
+            using rjmcmc::load_state;
+            load_state(is,s.m_schedule);
+            rjmcmc::read_binary(is,s.m_t);
+            rjmcmc::read_binary(is,s.m_i);
+        }
+
     private:
         // Wrapped schedule
 	Schedule m_schedule;
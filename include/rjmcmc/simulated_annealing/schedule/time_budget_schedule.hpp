@@ -0,0 +1,130 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef TIME_BUDGET_SCHEDULE_HPP
+#define TIME_BUDGET_SCHEDULE_HPP
+
+#include <cmath>
+#include <iterator>
+#include "rjmcmc/util/throughput_clock.hpp"
+#include "rjmcmc/simulated_annealing/schedule/geometric_schedule.hpp"
+
+namespace simulated_annealing {
+    /**
+     * \ingroup GroupSchedule
+     *
+     * This class is a model of the Schedule concept and implements a geometric schedule
+     * that reaches the temperature `final_temp` when `seconds` of wall clock time have elapsed since its first increment.
+     * Instead of being set from a guessed number of iterations, the decrease coefficient is updated at each reading of the clock
+     * (about every `period` seconds) from the measured number of iterations per second:
+     * \f[\alpha=\left(T_{final}/T\right)^{1/(r\,(s-t))}\f]
+     * where \f$r\f$ is the throughput and \f$s-t\f$ is the remaining time.
+     * The temperature is held at `final_temp` once the budget is spent. It is meant to be used with a time_budget_end_test of the same budget.
+     * As the clock is ticked by its increments, the batched run_iterations of any_sampler does not compute its temperatures ahead.
+     */
+    template<typename T>
+    class time_budget_schedule {
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T                       value_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef value_type*             pointer;
+        typedef value_type&             reference;
+
+        bool operator==(const time_budget_schedule<T>& s) const { return (m_temp==s.m_temp) && (m_alpha==s.m_alpha); }
+        bool operator!=(const time_budget_schedule<T>& s) const { return !(*this==s); }
+
+        /// @param temp Initial temperature
+        /// @param final_temp Temperature reached when the budget runs out
+        /// @param seconds Wall clock time budget
+        time_budget_schedule(value_type temp, value_type final_temp, double seconds, double period = 1e-3)
+            : m_temp(temp), m_alpha(1), m_final(final_temp), m_budget(seconds), m_clock(period) {}
+
+        /// rescales the geometric schedule `s`, starting at its current temperature
+        time_budget_schedule(const geometric_schedule<T>& s, value_type final_temp, double seconds, double period = 1e-3)
+            : m_temp(*s), m_alpha(1), m_final(final_temp), m_budget(seconds), m_clock(period) {}
+
+        inline value_type  operator*() const { return m_temp; }
+        inline time_budget_schedule<T>& operator++()    { increment(); return *this; }
+        inline time_budget_schedule<T>  operator++(int) { time_budget_schedule<T> t(*this); increment(); return t; }
+
+        inline value_type alpha() const { return m_alpha; }
+        inline value_type final_temperature() const { return m_final; }
+        inline double elapsed() const { return m_clock.elapsed(); }
+
+        // the throughput is measured between the increments, which must be interleaved with the iterations
+        friend inline bool prefetch_temperatures(const time_budget_schedule&) { return false; }
+
+        friend void save_state(std::ostream& os, const time_budget_schedule& s) {
+            rjmcmc::write_binary(os,s.m_temp);
+            rjmcmc::write_binary(os,s.m_alpha);
+            save_state(os,s.m_clock);
+        }
+        friend void load_state(std::istream& is, time_budget_schedule& s) {
+            rjmcmc::read_binary(is,s.m_temp);
+            rjmcmc::read_binary(is,s.m_alpha);
+            load_state(is,s.m_clock);
+        }
+
+    private:
+        inline void increment()
+        {
+            m_temp *= m_alpha;
+            if(m_clock.tick()) rescale();
+        }
+
+        void rescale()
+        {
+            if(m_clock.rate()<=0) return; // no throughput measured yet
+            double n = m_clock.rate()*(m_budget-m_clock.elapsed()); // expected remaining iterations
+            if(n<=1) { m_temp = m_final; m_alpha = 1; }
+            else m_alpha = std::pow(m_final/m_temp,1./n);
+        }
+
+        // Current temperature
+        value_type m_temp;
+        // Current geometric decrease coefficient
+        value_type m_alpha;
+        value_type m_final;
+        double m_budget;
+        rjmcmc::throughput_clock m_clock;
+    };
+
+}; // namespace simulated_annealing
+
+#endif // TIME_BUDGET_SCHEDULE_HPP
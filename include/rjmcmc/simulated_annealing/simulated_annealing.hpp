@@ -72,6 +72,38 @@ namespace simulated_annealing
         //]
     }
 
+    /**
+     * Same as above, also tracking the lowest energy configuration visited with
+     * best (see best_visitor) : config is rolled back to it before visitor.end().
+     */
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest,
+            typename Visitor, typename BestVisitor
+            >
+            void optimize(
+                    Engine& e,
+                    Configuration& config, Sampler& sampler,
+                    Schedule& schedule, EndTest& end_test,
+                    Visitor& visitor, BestVisitor& best )
+    {
+        BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+        double t = *schedule;
+        visitor.begin(config,sampler,t);
+        best.begin(config,sampler,t);
+        for(; !end_test(config,sampler,t); t = *(++schedule))
+        {
+            sampler(e,config,t);
+            visitor.visit(config,sampler,t);
+            best.visit(config,sampler,t);
+        }
+        best.end(config,sampler,t);
+        best.restore();
+        visitor.end(config,sampler,t);
+    }
+
     template<
             typename Engine,
             typename Configuration, typename Sampler,
@@ -38,6 +38,10 @@ knowledge of the CeCILL license and that you accept its terms.
 #define ANY_VISITOR_HPP
 
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
 
 namespace simulated_annealing {
 
@@ -54,6 +58,10 @@ namespace simulated_annealing {
             virtual void begin(const Configuration& config, const Sampler& sample, double t)=0;
             virtual void visit(const Configuration& config, const Sampler& sample, double t)=0;
             virtual void end  (const Configuration& config, const Sampler& sample, double t)=0;
+            virtual unsigned int idle() const = 0;
+            virtual void skip(unsigned int n, const kernel_statistics *stats) = 0;
+            virtual void save(std::ostream& os) const = 0;
+            virtual void load(std::istream& is) = 0;
         };
 
         template<typename Configuration, typename Sampler, typename T>
@@ -67,6 +75,10 @@ namespace simulated_annealing {
             virtual void begin(const Configuration& config, const Sampler& sample, double t) { held.begin(config,sample,t); }
             virtual void visit(const Configuration& config, const Sampler& sample, double t) { held.visit(config,sample,t); }
             virtual void end  (const Configuration& config, const Sampler& sample, double t) { held.end  (config,sample,t); }
+            virtual unsigned int idle() const { return idle_iterations(held); }
+            virtual void skip(unsigned int n, const kernel_statistics *stats) { skip_iterations(held,n,stats); }
+            virtual void save(std::ostream& os) const { using rjmcmc::save_state; save_state(os,held); }
+            virtual void load(std::istream& is) { using rjmcmc::load_state; load_state(is,held); }
 
         private:
             T held;
@@ -105,6 +117,11 @@ namespace simulated_annealing {
         void visit(const Configuration& config, const Sampler& sample, double t) { content->visit(config,sample,t); }
         void end  (const Configuration& config, const Sampler& sample, double t) { content->end(config,sample,t); }
 
+        friend unsigned int idle_iterations(const any_visitor& v) { return v.content->idle(); }
+        friend void skip_iterations(any_visitor& v, unsigned int n, const kernel_statistics *stats) { v.content->skip(n,stats); }
+        friend void save_state(std::ostream& os, const any_visitor& v) { v.content->save(os); }
+        friend void load_state(std::istream& is, any_visitor& v) { v.content->load(is); }
+
     private:
         detail::placeholder<Configuration,Sampler>* content;
     };
@@ -120,6 +137,25 @@ namespace simulated_annealing {
         void begin(const Configuration& config, const Sampler& sample, double t) { for(iterator it=base::begin(); it!=base::end(); ++it) it->begin(config,sample,t); }
         void visit(const Configuration& config, const Sampler& sample, double t) { for(iterator it=base::begin(); it!=base::end(); ++it) it->visit(config,sample,t); }
         void end  (const Configuration& config, const Sampler& sample, double t) { for(iterator it=base::begin(); it!=base::end(); ++it) it->end(config,sample,t); }
+
+        friend unsigned int idle_iterations(const any_composite_visitor& v)
+        {
+            unsigned int n = (std::numeric_limits<unsigned int>::max)();
+            for(typename base::const_iterator it=v.base::begin(); it!=v.base::end(); ++it) n = (std::min)(n,idle_iterations(*it));
+            return n;
+        }
+        friend void skip_iterations(any_composite_visitor& v, unsigned int n, const kernel_statistics *stats)
+        {
+            for(iterator it=v.base::begin(); it!=v.base::end(); ++it) skip_iterations(*it,n,stats);
+        }
+        friend void save_state(std::ostream& os, const any_composite_visitor& v)
+        {
+            for(typename base::const_iterator it=v.base::begin(); it!=v.base::end(); ++it) save_state(os,*it);
+        }
+        friend void load_state(std::istream& is, any_composite_visitor& v)
+        {
+            for(iterator it=v.base::begin(); it!=v.base::end(); ++it) load_state(is,*it);
+        }
     };
 
 
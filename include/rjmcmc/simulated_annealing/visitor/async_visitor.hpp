@@ -0,0 +1,338 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef ASYNC_VISITOR_HPP
+#define ASYNC_VISITOR_HPP
+
+#include <vector>
+#include <string>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
+namespace simulated_annealing {
+
+    /**
+     * Copy of the object values and energies of a configuration, modeling the read-only
+     * part of the configuration interface used by visitors (size, energies, iteration and for_each).
+     */
+    template<typename Configuration>
+    class configuration_snapshot
+    {
+    public:
+        typedef typename Configuration::value_type value_type;
+        typedef typename std::vector<value_type>::const_iterator const_iterator;
+        typedef const_iterator iterator;
+
+        void assign(const Configuration& c)
+        {
+            m_values.clear(); // keeps the capacity
+            c.for_each(pusher(m_values));
+            m_unary  = c.unary_energy();
+            m_binary = c.binary_energy();
+        }
+
+        inline size_t size() const { return m_values.size(); }
+        inline bool empty() const { return m_values.empty(); }
+        inline double unary_energy () const { return m_unary; }
+        inline double binary_energy() const { return m_binary; }
+        inline double energy       () const { return m_unary+m_binary; }
+        inline const_iterator begin() const { return m_values.begin(); }
+        inline const_iterator end  () const { return m_values.end(); }
+        inline const value_type& value(const_iterator it) const { return *it; }
+        template<typename F> inline void for_each(F f) const {
+            for(const_iterator it=begin(); it!=end(); ++it) rjmcmc::apply_visitor(f,*it);
+        }
+
+    private:
+        struct pusher {
+            typedef void result_type;
+            std::vector<value_type> *m_values;
+            pusher(std::vector<value_type>& v) : m_values(&v) {}
+            template<typename T> void operator()(const T& t) const { m_values->push_back(t); }
+        };
+
+        std::vector<value_type> m_values;
+        double m_unary, m_binary;
+    };
+
+    /**
+     * Copy of the statistics of the latest step of a sampler, modeling the part of the sampler
+     * interface used by visitors. The kernel names are shared with the snapshot source.
+     */
+    class sampler_snapshot
+    {
+    public:
+        sampler_snapshot() : m_names(NULL) {}
+
+        template<typename Sampler>
+        void assign(const Sampler& s, const std::vector<std::string>& names)
+        {
+            m_names = &names;
+            m_kernel_id = s.kernel_id();
+            m_accepted = s.accepted();
+            m_acceptance_probability = s.acceptance_probability();
+            m_temperature = s.temperature();
+            m_delta = s.delta();
+            m_green_ratio = s.green_ratio();
+            m_kernel_ratio = s.kernel_ratio();
+            m_ref_pdf_ratio = s.ref_pdf_ratio();
+            m_early_rejected = s.early_rejected();
+        }
+
+        inline unsigned int kernel_size() const { return m_names->size(); }
+        inline const std::string& kernel_name(unsigned int i) const { return (*m_names)[i]; }
+        inline unsigned int kernel_id() const { return m_kernel_id; }
+        inline bool accepted() const { return m_accepted; }
+        inline double acceptance_probability() const { return m_acceptance_probability; }
+        inline double temperature() const { return m_temperature; }
+        inline double delta() const { return m_delta; }
+        inline double green_ratio() const { return m_green_ratio; }
+        inline double kernel_ratio() const { return m_kernel_ratio; }
+        inline double ref_pdf_ratio() const { return m_ref_pdf_ratio; }
+        inline bool early_rejected() const { return m_early_rejected; }
+
+    private:
+        const std::vector<std::string> *m_names;
+        unsigned int m_kernel_id;
+        bool m_accepted, m_early_rejected;
+        double m_acceptance_probability, m_temperature, m_delta, m_green_ratio, m_kernel_ratio, m_ref_pdf_ratio;
+    };
+
+    /**
+     * Runs the visits of a wrapped visitor on a dedicated I/O thread, so that slow visits
+     * (writing files, printing) do not stall the sampling loop.
+     * Each interesting visit enqueues a snapshot of the configuration values and of the sampler
+     * statistics to a bounded lock-free queue, together with the per-kernel statistics of the
+     * iterations since the previous snapshot, which the I/O thread hands to skip_iterations before
+     * the visit. When the queue is full, the visit either waits for a free slot (block) or is
+     * dropped (drop), its iteration being then skipped along with the next snapshot.
+     *
+     * The interesting visits are those after the idle_iterations of the wrapped visitor right after its begin(),
+     * which is assumed periodic (as ostream_visitor and shp_visitor are). begin() and end() are called
+     * synchronously, end() after all the pending visits. The wrapped visitor is held by reference.
+     */
+    template<typename Visitor, typename Configuration>
+    class async_visitor
+    {
+    public:
+        enum policy { block, drop };
+
+        async_visitor(Visitor& visitor, unsigned int capacity=16, policy p=block) :
+                m_visitor(visitor), m_policy(p), m_capacity(capacity), m_queue(capacity), m_free(capacity), m_stop(false) {}
+
+        ~async_visitor() { stop(); }
+
+        void init(int dump, int save) { m_visitor.init(dump,save); }
+
+        template<typename Sampler>
+        void begin(const Configuration& config, const Sampler& sampler, double t)
+        {
+            stop();
+            m_visitor.begin(config,sampler,t);
+            m_period = idle_iterations(m_visitor);
+            m_idle = m_period;
+            m_skipped = 0;
+            m_dropped = 0;
+            m_names.resize(sampler.kernel_size());
+            for(unsigned int i=0; i<m_names.size(); ++i) m_names[i] = sampler.kernel_name(i);
+            m_stats.begin(sampler);
+
+            m_pool.resize(m_capacity);
+            for(unsigned int i=0; i<m_capacity; ++i) {
+                m_pool[i].stats.begin(sampler);
+                m_free.push(&m_pool[i]);
+            }
+            m_stop = false;
+            m_thread.reset(new boost::thread(boost::bind(&async_visitor::run,this)));
+        }
+
+        template<typename Sampler>
+        void visit(const Configuration& config, const Sampler& sampler, double t)
+        {
+            if(m_idle) {
+                --m_idle;
+                ++m_skipped;
+                m_stats(sampler);
+                return;
+            }
+            m_idle = m_period;
+            snapshot *s;
+            if(m_policy==block) {
+                if(!m_free.pop(s)) {
+                    boost::unique_lock<boost::mutex> lock(m_mutex);
+                    while(!m_free.pop(s)) m_freed.wait(lock);
+                }
+            } else if(!m_free.pop(s)) {
+                ++m_dropped;
+                ++m_skipped;
+                m_stats(sampler);
+                return;
+            }
+            s->skipped = m_skipped;
+            s->stats.reset();
+            s->stats += m_stats;
+            s->config.assign(config);
+            s->sampler.assign(sampler,m_names);
+            s->t = t;
+            m_skipped = 0;
+            m_stats.reset();
+            m_queue.push(s);
+            notify(m_filled);
+        }
+
+        template<typename Sampler>
+        void end(const Configuration& config, const Sampler& sampler, double t)
+        {
+            stop();
+            if(m_skipped) skip_iterations(m_visitor,m_skipped,&m_stats);
+            m_visitor.end(config,sampler,t);
+        }
+
+        /// number of visits dropped since begin() (drop policy only)
+        inline unsigned int dropped() const { return m_dropped; }
+
+        friend unsigned int idle_iterations(const async_visitor& v) { return v.m_idle; }
+        friend void skip_iterations(async_visitor& v, unsigned int n, const kernel_statistics *stats)
+        {
+            v.m_idle -= n;
+            v.m_skipped += n;
+            if(stats) v.m_stats += *stats;
+        }
+
+        // the pending visits are drained first, so that the state of the wrapped visitor is the one of this iteration
+        friend void save_state(std::ostream& os, const async_visitor& v)
+        {
+            using rjmcmc::save_state;
+            v.drain();
+            save_state(os,v.m_visitor);
+            rjmcmc::write_binary(os,boost::uint32_t(v.m_idle));
+            rjmcmc::write_binary(os,boost::uint32_t(v.m_skipped));
+            save_state(os,v.m_stats);
+        }
+        friend void load_state(std::istream& is, async_visitor& v)
+        {
+            using rjmcmc::load_state;
+            v.drain();
+            load_state(is,v.m_visitor);
+            boost::uint32_t idle = 0, skipped = 0;
+            rjmcmc::read_binary(is,idle);
+            rjmcmc::read_binary(is,skipped);
+            v.m_idle = idle;
+            v.m_skipped = skipped;
+            load_state(is,v.m_stats);
+        }
+
+    private:
+        struct snapshot {
+            unsigned int skipped;
+            kernel_statistics stats;
+            configuration_snapshot<Configuration> config;
+            sampler_snapshot sampler;
+            double t;
+        };
+
+        // I/O thread : visits the snapshots until stop() and the queue is drained, sleeping while the queue is empty
+        void run()
+        {
+            snapshot *s;
+            for(;;) {
+                bool stopping = m_stop;
+                while(m_queue.pop(s)) {
+                    if(s->skipped) skip_iterations(m_visitor,s->skipped,&s->stats);
+                    m_visitor.visit(s->config,s->sampler,s->t);
+                    m_free.push(s);
+                    notify(m_freed);
+                }
+                if(stopping) return;
+                boost::unique_lock<boost::mutex> lock(m_mutex);
+                while(!m_stop && !m_queue.read_available()) m_filled.wait(lock);
+            }
+        }
+
+        // the queues are lock-free : the mutex only orders the notification after the check of a waiting thread
+        void notify(boost::condition_variable& c)
+        {
+            { boost::lock_guard<boost::mutex> lock(m_mutex); }
+            c.notify_one();
+        }
+
+        // waits until the I/O thread consumed all the snapshots
+        void drain() const
+        {
+            if(!m_thread) return;
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while(m_free.read_available()<m_capacity) m_freed.wait(lock);
+        }
+
+        void stop()
+        {
+            if(!m_thread) return;
+            m_stop = true;
+            notify(m_filled);
+            m_thread->join();
+            m_thread.reset();
+            snapshot *s;
+            while(m_free.pop(s)) {}
+        }
+
+        Visitor& m_visitor;
+        policy m_policy;
+        unsigned int m_capacity;
+        unsigned int m_period, m_idle, m_skipped, m_dropped;
+        kernel_statistics m_stats;
+        std::vector<std::string> m_names;
+        std::vector<snapshot> m_pool;
+        boost::lockfree::spsc_queue<snapshot *> m_queue; // filled snapshots, to the I/O thread
+        boost::lockfree::spsc_queue<snapshot *> m_free;  // consumed snapshots, back to the sampling thread
+        boost::atomic<bool> m_stop;
+        mutable boost::mutex m_mutex;
+        boost::condition_variable m_filled; // signals a filled snapshot or stop() to the I/O thread
+        mutable boost::condition_variable m_freed;  // signals a consumed snapshot to the sampling thread (block policy, drain)
+        boost::scoped_ptr<boost::thread> m_thread;
+    };
+
+} // namespace simulated_annealing
+
+#endif // ASYNC_VISITOR_HPP
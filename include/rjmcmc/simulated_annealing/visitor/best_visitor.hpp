@@ -0,0 +1,126 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef BEST_VISITOR_HPP
+#define BEST_VISITOR_HPP
+
+#include <limits>
+#include <cassert>
+#include <boost/shared_ptr.hpp>
+
+namespace simulated_annealing {
+
+    /**
+     * Keeps track of the lowest energy configuration visited, without copying it.
+     * The configuration is kept in a transaction opened at the best state so far,
+     * whose undo log is the diff of births and deaths since this best state.
+     * best() materializes it lazily from this diff, and restore() rolls the
+     * configuration back to it. The Configuration must support transactions,
+     * as graph_configuration does. The visited configuration is given to the
+     * constructor, as the visitor opens transactions on it : the transaction is
+     * committed and reopened at each improvement, so that the undo log only
+     * holds the accepted modifications since the latest improvement.
+     */
+    template<typename Configuration>
+    class best_visitor
+    {
+    public:
+        explicit best_visitor(Configuration& config) : m_energy((std::numeric_limits<double>::max)()), m_config(&config), m_valid(false) {}
+
+        void init(int, int) {}
+
+        template<typename Sampler>
+        void begin(const Configuration& config, const Sampler&, double)
+        {
+            assert(&config==m_config);
+            improve();
+        }
+
+        template<typename Sampler>
+        void visit(const Configuration& config, const Sampler&, double)
+        {
+            if(config.energy()<m_energy) improve();
+        }
+
+        // the transaction stays open, so that best() and restore() remain available
+        template<typename Sampler>
+        void end(const Configuration& config, const Sampler&, double)
+        {
+            if(config.energy()<m_energy) improve();
+        }
+
+        /// energy of the best configuration visited
+        inline double energy() const { return m_energy; }
+
+        /// the best configuration visited, rebuilt on the first call after each improvement
+        const Configuration& best()
+        {
+            if(!m_valid) {
+                if(!m_best) m_best.reset(new Configuration(m_config->unary_energy_functor(),m_config->binary_energy_functor(),m_config->accelerator()));
+                if(m_config->in_transaction()) m_config->transaction_origin(*m_best);
+                else *m_best = *m_config;
+                m_valid = true;
+            }
+            return *m_best;
+        }
+
+        /// rolls the visited configuration back to the best configuration, and stops tracking
+        void restore()
+        {
+            if(m_config->in_transaction()) m_config->rollback();
+            m_valid = false;
+        }
+
+    private:
+        // the current configuration is the new best : its diff restarts from scratch
+        void improve()
+        {
+            m_energy = m_config->energy();
+            if(m_config->in_transaction()) m_config->commit();
+            m_config->begin_transaction();
+            m_valid  = false;
+        }
+
+        double m_energy;
+        Configuration *m_config;
+        boost::shared_ptr<Configuration> m_best;
+        bool m_valid;
+    };
+
+}
+
+#endif // BEST_VISITOR_HPP
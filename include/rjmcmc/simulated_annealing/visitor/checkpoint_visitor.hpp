@@ -0,0 +1,213 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef CHECKPOINT_VISITOR_HPP
+#define CHECKPOINT_VISITOR_HPP
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
+
+namespace simulated_annealing {
+
+    namespace internal
+    {
+        static const char checkpoint_magic[8] = { 'r','j','m','c','m','c','c','k' };
+        static const boost::uint32_t checkpoint_version = 1;
+    }
+
+    /**
+     * Writes a binary checkpoint of an optimization in `file` : the engine, the configuration, the sampler,
+     * the schedule, the end test and the visitor (as a length-prefixed block, restored after its begin()).
+     * The checkpoint is first written to `file`.tmp, then renamed, so that `file` is always a complete checkpoint.
+     * The layout uses the native endianness and the save_state hooks of each model.
+     */
+    template<typename Engine, typename Configuration, typename Sampler, typename Schedule, typename EndTest, typename Visitor>
+    bool save_checkpoint(const std::string& file, const Engine& e, const Configuration& config, const Sampler& sampler,
+                         const Schedule& schedule, const EndTest& end_test, const Visitor& visitor)
+    {
+        using rjmcmc::save_state;
+        std::ostringstream v(std::ios::binary);
+        save_state(v,visitor);
+        std::string visitor_state = v.str();
+
+        std::string tmp = file+".tmp";
+        {
+            std::ofstream os(tmp.c_str(), std::ios::binary | std::ios::trunc);
+            os.write(internal::checkpoint_magic,sizeof(internal::checkpoint_magic));
+            rjmcmc::write_binary(os,internal::checkpoint_version);
+            save_state(os,e);
+            save_state(os,config);
+            save_state(os,sampler);
+            save_state(os,schedule);
+            save_state(os,end_test);
+            rjmcmc::write_binary(os,boost::uint64_t(visitor_state.size()));
+            os.write(visitor_state.data(),visitor_state.size());
+            if(!os.flush()) return false;
+        }
+        return std::rename(tmp.c_str(),file.c_str())==0;
+    }
+
+    /**
+     * Reads a checkpoint written by save_checkpoint with the same model types and parameters.
+     * The state of the visitor is returned in `visitor_state`, to be loaded after its begin().
+     */
+    template<typename Engine, typename Configuration, typename Sampler, typename Schedule, typename EndTest>
+    bool load_checkpoint(const std::string& file, Engine& e, Configuration& config, Sampler& sampler,
+                         Schedule& schedule, EndTest& end_test, std::string& visitor_state)
+    {
+        using rjmcmc::load_state;
+        std::ifstream is(file.c_str(), std::ios::binary);
+        char magic[sizeof(internal::checkpoint_magic)];
+        boost::uint32_t version = 0;
+        is.read(magic,sizeof(magic));
+        rjmcmc::read_binary(is,version);
+        if(!is || std::memcmp(magic,internal::checkpoint_magic,sizeof(magic)) || version!=internal::checkpoint_version) return false;
+        load_state(is,e);
+        load_state(is,config);
+        load_state(is,sampler);
+        load_state(is,schedule);
+        load_state(is,end_test);
+        boost::uint64_t n = 0;
+        rjmcmc::read_binary(is,n);
+        visitor_state.resize(n);
+        if(n) is.read(&visitor_state[0],n);
+        return bool(is);
+    }
+
+    /**
+     * Wraps a visitor and writes a checkpoint of the whole optimization every `every` iterations
+     * (the schedule being saved at the temperature of the next iteration). resume() restores a checkpoint
+     * before the optimization is launched, the wrapped visitor and the iteration count being restored after its begin().
+     * Engine, schedule and end test are held by reference : they must be the ones driving the optimization.
+     */
+    template<typename Visitor, typename Engine, typename Schedule, typename EndTest>
+    class checkpoint_visitor
+    {
+    public:
+        checkpoint_visitor(Visitor& visitor, Engine& e, Schedule& schedule, EndTest& end_test,
+                           const std::string& file, unsigned int every) :
+                m_visitor(visitor), m_engine(e), m_schedule(schedule), m_end_test(end_test),
+                m_file(file), m_every(every), m_iter(0) {}
+
+        template<typename Configuration, typename Sampler>
+        bool resume(const std::string& file, Configuration& config, Sampler& sampler)
+        {
+            return load_checkpoint(file,m_engine,config,sampler,m_schedule,m_end_test,m_pending);
+        }
+
+        void init(int dump, int save) { m_visitor.init(dump,save); }
+
+        template<typename Configuration, typename Sampler>
+        void begin(const Configuration& config, const Sampler& sampler, double t)
+        {
+            m_visitor.begin(config,sampler,t);
+            m_iter = 0;
+            if(m_pending.empty()) return;
+            using rjmcmc::load_state;
+            std::istringstream is(m_pending, std::ios::binary);
+            load_state(is,*this);
+            m_pending.clear();
+        }
+
+        template<typename Configuration, typename Sampler>
+        void visit(const Configuration& config, const Sampler& sampler, double t)
+        {
+            m_visitor.visit(config,sampler,t);
+            if(m_every && ++m_iter%m_every==0) save(config,sampler);
+        }
+
+        template<typename Configuration, typename Sampler>
+        void end(const Configuration& config, const Sampler& sampler, double t) { m_visitor.end(config,sampler,t); }
+
+        friend unsigned int idle_iterations(const checkpoint_visitor& v)
+        {
+            unsigned int n = v.m_every ? v.m_every - 1 - v.m_iter % v.m_every : (std::numeric_limits<unsigned int>::max)();
+            return (std::min)(n,idle_iterations(v.m_visitor));
+        }
+        friend void skip_iterations(checkpoint_visitor& v, unsigned int n, const kernel_statistics *stats)
+        {
+            v.m_iter += n;
+            skip_iterations(v.m_visitor,n,stats);
+        }
+
+        // the iteration count is saved with the wrapped visitor, to keep the checkpoint cadence on resume
+        friend void save_state(std::ostream& os, const checkpoint_visitor& v)
+        {
+            using rjmcmc::save_state;
+            rjmcmc::write_binary(os,boost::uint32_t(v.m_iter));
+            save_state(os,v.m_visitor);
+        }
+        friend void load_state(std::istream& is, checkpoint_visitor& v)
+        {
+            using rjmcmc::load_state;
+            boost::uint32_t iter = 0;
+            rjmcmc::read_binary(is,iter);
+            v.m_iter = iter;
+            load_state(is,v.m_visitor);
+        }
+
+    private:
+        template<typename Configuration, typename Sampler>
+        void save(const Configuration& config, const Sampler& sampler)
+        {
+            // the loop increments the schedule after the visit
+            Schedule next(m_schedule);
+            ++next;
+            if(!save_checkpoint(m_file,m_engine,config,sampler,next,m_end_test,*this))
+                std::cerr << "Unable to write the checkpoint " << m_file << std::endl;
+        }
+
+        Visitor& m_visitor;
+        Engine& m_engine;
+        Schedule& m_schedule;
+        EndTest& m_end_test;
+        std::string m_file;
+        unsigned int m_every, m_iter;
+        std::string m_pending;
+    };
+
+} // namespace simulated_annealing
+
+#endif // CHECKPOINT_VISITOR_HPP
@@ -38,6 +38,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #define COMPOSITE_VISITOR_HPP
 
 #include "rjmcmc/util/tuple.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
 
 namespace simulated_annealing {
 
@@ -117,6 +119,31 @@ namespace simulated_annealing {
             internal::visitor_end<Configuration,Sampler> v(config,sample,t);
             rjmcmc::for_each(m_visitors,v);
         }
+
+        friend unsigned int idle_iterations(const composite_visitor& c)
+        {
+            internal::idle_iterations_min v;
+            rjmcmc::for_each(const_cast<Visitors&>(c.m_visitors),v);
+            return v.value();
+        }
+
+        friend void skip_iterations(composite_visitor& c, unsigned int n, const kernel_statistics *stats)
+        {
+            internal::skip_iterations_all v(n,stats);
+            rjmcmc::for_each(c.m_visitors,v);
+        }
+
+        friend void save_state(std::ostream& os, const composite_visitor& c)
+        {
+            rjmcmc::internal::save_state_all v(os);
+            rjmcmc::for_each(const_cast<Visitors&>(c.m_visitors),v);
+        }
+
+        friend void load_state(std::istream& is, composite_visitor& c)
+        {
+            rjmcmc::internal::load_state_all v(is);
+            rjmcmc::for_each(c.m_visitors,v);
+        }
     private:
         Visitors m_visitors;
     };
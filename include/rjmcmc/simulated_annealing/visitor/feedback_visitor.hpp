@@ -0,0 +1,83 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef FEEDBACK_VISITOR_HPP
+#define FEEDBACK_VISITOR_HPP
+
+#include "rjmcmc/util/checkpoint.hpp"
+
+namespace simulated_annealing {
+
+    //[feedback_hook
+    /// hands the outcome of the latest iteration of `sampler` to the schedule `s` (default : ignored)
+    template<typename Schedule, typename Sampler>
+    inline void feedback(Schedule&, const Sampler&) {}
+    //]
+
+    /**
+     * \ingroup GroupVisitor
+     *
+     * This class is a model of the Visitor concept that feeds the outcome of each iteration back to a schedule
+     * held by reference, through the feedback hook that adaptive schedules such as adaptive_schedule overload.
+     * It is typically combined with other visitors in a composite_visitor. It observes each iteration,
+     * so chunked_optimize does not skip any of them while it is used.
+     */
+    template<typename Schedule>
+    class feedback_visitor
+    {
+    public:
+        feedback_visitor(Schedule& schedule) : m_schedule(schedule) {}
+
+        void init(int, int) {}
+        template<typename Configuration, typename Sampler>
+        void begin(const Configuration&, const Sampler&, double) {}
+        template<typename Configuration, typename Sampler>
+        void end(const Configuration&, const Sampler&, double) {}
+        template<typename Configuration, typename Sampler>
+        inline void visit(const Configuration&, const Sampler& sampler, double) { feedback(m_schedule,sampler); }
+
+        // the schedule is checkpointed on its own
+        friend void save_state(std::ostream&, const feedback_visitor&) {}
+        friend void load_state(std::istream&, feedback_visitor&) {}
+
+    private:
+        Schedule& m_schedule;
+    };
+
+}; // namespace simulated_annealing
+
+#endif // FEEDBACK_VISITOR_HPP
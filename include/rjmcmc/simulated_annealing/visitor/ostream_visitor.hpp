@@ -39,6 +39,10 @@ knowledge of the CeCILL license and that you accept its terms.
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <limits>
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
 
 #if USE_CPP11
 #include <chrono>
@@ -65,13 +69,14 @@ namespace simulated_annealing {
 
         unsigned int m_dump;
         unsigned int m_iter;
+        unsigned int m_kernel_size;
         int w;
 	int p;
         std::ostream& m_out;
         bool m_add_endline; // todo: compile time with mpl::true_/false_
 
     public:
-        ostream_visitor(std::ostream& out=std::cout, bool add_endline=true) : m_proposed(NULL), m_accepted(NULL), m_out(out), m_add_endline(add_endline) {}
+        ostream_visitor(std::ostream& out=std::cout, bool add_endline=true) : m_proposed(NULL), m_accepted(NULL), m_kernel_size(0), m_out(out), m_add_endline(add_endline) {}
         ~ostream_visitor() {
             if(m_accepted) delete m_accepted;
             if(m_proposed) delete m_proposed;
@@ -86,6 +91,7 @@ namespace simulated_annealing {
         void begin(const Configuration& config, const Sampler& sampler, double)
         {
             unsigned int kernel_size =  sampler.kernel_size();
+            m_kernel_size = kernel_size;
 
             if(m_accepted) delete m_accepted;
             if(m_proposed) delete m_proposed;
@@ -181,7 +187,12 @@ namespace simulated_annealing {
                 m_out << std::setw(w) << std::setprecision(p) << config.energy();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.acceptance_probability();
                 //m_out << std::setw(w) << std::setprecision(p) << sampler.temperature();
-                m_out << std::setw(w) << std::setprecision(p) << sampler.delta();
+                if(sampler.early_rejected()) { // only a lower bound of the energy variation is known
+                    std::ostringstream bound;
+                    bound << '>' << std::setprecision(p) << sampler.delta();
+                    m_out << std::setw(w) << bound.str();
+                }
+                else m_out << std::setw(w) << std::setprecision(p) << sampler.delta();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.green_ratio();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.accepted();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.kernel_ratio();
@@ -192,6 +203,30 @@ namespace simulated_annealing {
                 m_out << std::flush;
             }
         }
+
+        // only the dumping visits are interesting, per-kernel counts of the others come from stats
+        friend inline unsigned int idle_iterations(const ostream_visitor& v) {
+            return v.m_dump ? v.m_dump - 1 - v.m_iter % v.m_dump : (std::numeric_limits<unsigned int>::max)();
+        }
+        friend void skip_iterations(ostream_visitor& v, unsigned int n, const kernel_statistics *stats) {
+            v.m_iter += n;
+            if(!stats) return;
+            for(unsigned int k=0; k<stats->size(); ++k)
+            {
+                v.m_proposed[k] += stats->proposed(k);
+                v.m_accepted[k] += stats->accepted(k);
+            }
+        }
+
+        // the iteration count and the per-kernel counts since the latest dump (load after begin)
+        friend void save_state(std::ostream& os, const ostream_visitor& v) {
+            rjmcmc::write_binary(os,v.m_iter);
+            for(unsigned int k=0; k<v.m_kernel_size; ++k) { rjmcmc::write_binary(os,v.m_proposed[k]); rjmcmc::write_binary(os,v.m_accepted[k]); }
+        }
+        friend void load_state(std::istream& is, ostream_visitor& v) {
+            rjmcmc::read_binary(is,v.m_iter);
+            for(unsigned int k=0; k<v.m_kernel_size; ++k) { rjmcmc::read_binary(is,v.m_proposed[k]); rjmcmc::read_binary(is,v.m_accepted[k]); }
+        }
     };
 
 }; // namespace simulated_annealing
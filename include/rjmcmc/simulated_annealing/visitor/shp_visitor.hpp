@@ -116,6 +116,8 @@ struct shp_writer_wrapper
 #include <iomanip>
 #include <sstream>
 #include "rjmcmc/util/variant.hpp"
+#include "rjmcmc/util/checkpoint.hpp"
+#include "rjmcmc/simulated_annealing/kernel_statistics.hpp"
 
 namespace simulated_annealing {
     namespace shp {
@@ -149,6 +151,11 @@ namespace simulated_annealing {
                 if((++m_iter)%m_save==0)
                     save(config);
             }
+
+            friend unsigned int idle_iterations(const shp_visitor& v) { return v.m_save - 1 - v.m_iter % v.m_save; }
+            friend void skip_iterations(shp_visitor& v, unsigned int n, const kernel_statistics *) { v.m_iter += n; }
+            friend void save_state(std::ostream& os, const shp_visitor& v) { rjmcmc::write_binary(os,v.m_iter); }
+            friend void load_state(std::istream& is, shp_visitor& v) { rjmcmc::read_binary(is,v.m_iter); }
         private:
             unsigned int m_save, m_iter;
             std::string m_prefix;
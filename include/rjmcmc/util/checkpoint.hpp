@@ -0,0 +1,118 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef RJMCMC_CHECKPOINT_HPP
+#define RJMCMC_CHECKPOINT_HPP
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+namespace rjmcmc {
+
+    /// raw binary copy of a plain old data value (native endianness)
+    template<typename T>
+    inline void write_binary(std::ostream& os, const T& t) { os.write(reinterpret_cast<const char *>(&t), sizeof(T)); }
+
+    template<typename T>
+    inline void read_binary(std::istream& is, T& t) { is.read(reinterpret_cast<char *>(&t), sizeof(T)); }
+
+    //[checkpoint_hooks
+    /// writes the state of `t` that evolves during an optimization (no default : stateless models provide empty overloads)
+    template<typename T>
+    inline void save_state(std::ostream&, const T&)
+    {
+        BOOST_STATIC_ASSERT_MSG(sizeof(T)==0, "save_state is not provided for this type");
+    }
+
+    /// restores the state of `t` written by save_state
+    template<typename T>
+    inline void load_state(std::istream&, T&)
+    {
+        BOOST_STATIC_ASSERT_MSG(sizeof(T)==0, "load_state is not provided for this type");
+    }
+    //]
+    // Models provide these hooks with overloads found by argument dependent lookup,
+    // so they should be called unqualified after a `using rjmcmc::save_state;` declaration.
+    // The default templates only turn a missing overload into a compilation error rather than a silently lost state.
+
+    /// boost.random engines, through their textual representation
+    inline void save_state(std::ostream& os, const boost::mt19937& e)
+    {
+        std::ostringstream oss;
+        oss << e;
+        std::string s = oss.str();
+        write_binary(os,boost::uint64_t(s.size()));
+        os.write(s.data(),s.size());
+    }
+    inline void load_state(std::istream& is, boost::mt19937& e)
+    {
+        boost::uint64_t n = 0;
+        read_binary(is,n);
+        std::string s(n,' ');
+        if(n) is.read(&s[0],n);
+        std::istringstream iss(s);
+        iss >> e;
+    }
+
+    namespace internal
+    {
+        // hooks of composite models, forwarded to each element
+        struct save_state_all
+        {
+            std::ostream& m_os;
+            save_state_all(std::ostream& os) : m_os(os) {}
+            template<typename T> inline void operator()(const T& t) { using rjmcmc::save_state; save_state(m_os,t); }
+            template<typename T> inline void operator()(T* t) { operator()(*t); }
+        };
+
+        struct load_state_all
+        {
+            std::istream& m_is;
+            load_state_all(std::istream& is) : m_is(is) {}
+            template<typename T> inline void operator()(T& t) { using rjmcmc::load_state; load_state(m_is,t); }
+            template<typename T> inline void operator()(T* t) { operator()(*t); }
+        };
+    }
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_CHECKPOINT_HPP
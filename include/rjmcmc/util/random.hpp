@@ -37,7 +37,12 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef RANDOM_HPP
 #define RANDOM_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <boost/cstdint.hpp>
 #include <boost/random.hpp>
+#include "rjmcmc/util/checkpoint.hpp"
 
 #ifndef _WINDOWS
 #	include <sys/time.h>
@@ -49,23 +54,142 @@ namespace rjmcmc {
     typedef boost::mt19937 mt19937_generator;
 
     /**
- * @fn static RJMCMCRandom &GetRandom() Simple function which return an initialised random number generator
- * @todo Properly handle Windows platform
- */
-    static mt19937_generator &random()
+     * @fn time_seed() returns a seed based on the current time, for runs that need not be reproduced
+     */
+    inline boost::uint64_t time_seed()
     {
-        static mt19937_generator g;
 #ifndef WIN32
-	static bool uninitialised = true;
-	if (uninitialised)
-	{
-            struct timeval tv;
-            gettimeofday(&tv, 0);
-            g.seed(tv.tv_sec + tv.tv_usec);
-            uninitialised = false;
-	}
+        struct timeval tv;
+        gettimeofday(&tv, 0);
+        return boost::uint64_t(tv.tv_sec)*1000000 + tv.tv_usec;
+#else
+        return boost::uint64_t(std::time(0));
 #endif
-	return g;
+    }
+
+    /**
+     * xoshiro256** generator (Blackman and Vigna), a model of the UniformRandomNumberGenerator concept of boost::random.
+     * Its period is 2^256-1 and jump() advances it by 2^96, 2^128, 2^160 or 2^192 draws in constant time,
+     * which splits its sequence into non-overlapping streams that may safely be used by concurrent chains.
+     */
+    class xoshiro256_generator
+    {
+    public:
+        typedef boost::uint64_t result_type;
+        BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+        static result_type min BOOST_PREVENT_MACRO_SUBSTITUTION () { return 0; }
+        static result_type max BOOST_PREVENT_MACRO_SUBSTITUTION () { return ~result_type(0); }
+
+        explicit xoshiro256_generator(result_type value = 0) { seed(value); }
+
+        /// the 256 bits of the state are initialized from the 64 bits value using a splitmix64 generator
+        void seed(result_type value)
+        {
+            for(unsigned int i=0; i<4; ++i)
+            {
+                result_type z = (value += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                m_s[i] = z ^ (z >> 31);
+            }
+        }
+
+        inline result_type operator()()
+        {
+            const result_type res = rotl(m_s[1]*5, 7)*9;
+            const result_type t = m_s[1] << 17;
+            m_s[2] ^= m_s[0];
+            m_s[3] ^= m_s[1];
+            m_s[1] ^= m_s[2];
+            m_s[0] ^= m_s[3];
+            m_s[2] ^= t;
+            m_s[3] = rotl(m_s[3], 45);
+            return res;
+        }
+
+        /// equivalent to 2^log2_draws calls to operator(), log2_draws being 96, 128, 160 or 192
+        void jump(unsigned int log2_draws = 128)
+        {
+            // x^(2^k) modulo the characteristic polynomial of the generator, for k = 96, 128, 160 and 192
+            static const result_type jump_poly[4][4] = {
+                { 0x148c356c3114b7a9ULL, 0xcdb45d7def42c317ULL, 0xb27c05962ea56a13ULL, 0x31eebb6c82a9615fULL },
+                { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL },
+                { 0xc04b4f9c5d26c200ULL, 0x69e6e6e431a2d40bULL, 0x4823b45b89dc689cULL, 0xf567382197055bf0ULL },
+                { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL } };
+            assert(log2_draws>=96 && log2_draws<=192 && log2_draws%32==0);
+            const result_type *poly = jump_poly[(log2_draws-96)/32];
+            result_type s[4] = { 0, 0, 0, 0 };
+            for(unsigned int i=0; i<4; ++i)
+                for(unsigned int b=0; b<64; ++b)
+                {
+                    if(poly[i] & (result_type(1) << b))
+                        for(unsigned int j=0; j<4; ++j) s[j] ^= m_s[j];
+                    (*this)();
+                }
+            std::copy(s,s+4,m_s);
+        }
+
+        bool operator==(const xoshiro256_generator& g) const { return std::equal(m_s,m_s+4,g.m_s); }
+        bool operator!=(const xoshiro256_generator& g) const { return !(*this==g); }
+
+        friend void save_state(std::ostream& os, const xoshiro256_generator& g) { for(unsigned int i=0; i<4; ++i) write_binary(os,g.m_s[i]); }
+        friend void load_state(std::istream& is, xoshiro256_generator& g) { for(unsigned int i=0; i<4; ++i) read_binary(is,g.m_s[i]); }
+
+    private:
+        static inline result_type rotl(result_type x, int k) { return (x << k) | (x >> (64 - k)); }
+        result_type m_s[4];
+    };
+
+    typedef xoshiro256_generator stream_generator;
+
+    /**
+     * Levels of the hierarchy of streams, so that streams split from streams never overlap :
+     * - the streams of an engine_factory are 2^192 draws apart,
+     * - chain_stream : the chains, replicas or population members split from such a stream are 2^160 draws apart
+     *   (multi_chain_optimize, parallel_tempering, population_annealing),
+     * - worker_stream : the workers split from a chain are 2^96 draws apart (the proposal slots of speculative_sampler,
+     *   the cells of domain_decomposition_sampler), each worker having up to 2^96 draws.
+     */
+    enum stream_level { chain_stream = 160, worker_stream = 96 };
+
+    /**
+     * Engine factory handing out independent and reproducible streams keyed by (seed, stream id):
+     * stream i is the sequence of the generator seeded with seed, jumped i times by 2^192 draws.
+     * Each optimization should be given its own stream, its chains and workers being split from it by split_stream.
+     */
+    class engine_factory
+    {
+    public:
+        explicit engine_factory(boost::uint64_t seed) : m_seed(seed) {}
+
+        stream_generator operator()(unsigned int stream) const
+        {
+            stream_generator g(m_seed);
+            for(unsigned int i=0; i<stream; ++i) g.jump(192);
+            return g;
+        }
+
+        inline boost::uint64_t seed() const { return m_seed; }
+
+    private:
+        boost::uint64_t m_seed;
+    };
+
+    /**
+     * @fn split_stream(Engine& e, stream_level level) returns an engine for a new stream derived from e, which is modified.
+     * Generic engines are simply seeded with a draw of e.
+     * For stream_generator, the returned engine continues the sequence of e while e jumps ahead by the spacing of `level`,
+     * so that their sequences do not overlap, nor those of the streams later split from them at a lower level.
+     */
+    template<typename Engine>
+    inline Engine split_stream(Engine& e, stream_level = worker_stream) { return Engine(e()); }
+
+    inline stream_generator split_stream(stream_generator& e, stream_level level = worker_stream)
+    {
+        stream_generator g(e);
+        e.jump(level);
+        return g;
     }
 
 }; // namespace rjmcmc
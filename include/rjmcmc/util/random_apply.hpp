@@ -85,6 +85,39 @@ namespace rjmcmc {
                 return 0;
             }
         };
+
+        template <unsigned int I, unsigned int N> struct random_apply_cumulate
+        {
+            template <typename T>
+                    inline void operator()(double *cumul, double sum, const T& t) {
+                cumul[I] = sum + get<I>(t).probability();
+                random_apply_cumulate<I+1,N>()(cumul,cumul[I],t);
+            }
+        };
+
+        template <unsigned int N> struct random_apply_cumulate<N,N>
+        {
+            template <typename T>
+                    inline void operator()(double * /*cumul*/, double /*sum*/, const T& /*t*/) {}
+        };
+
+        // unrolled dispatch on the index i, known at runtime
+        template <unsigned int I, unsigned int N> struct random_apply_at
+        {
+            template <typename T, typename F>
+                    inline typename F::result_type operator()(unsigned int i, double x, T& t, F &f) {
+                if(i==I) return f(x,get<I>(t));
+                return random_apply_at<I+1,N>()(i,x,t,f);
+            }
+        };
+
+        template <unsigned int N> struct random_apply_at<N,N>
+        {
+            template <typename T, typename F>
+                    inline typename F::result_type operator()(unsigned int /*i*/, double /*x*/, T& /*t*/, F & /*f*/) {
+                return typename F::result_type();
+            }
+        };
     };
 
     template <typename T, typename F>
@@ -93,6 +126,37 @@ namespace rjmcmc {
         return detail::random_apply_impl<0,tuple_size<T>::value>()(i,x*normalisation,t,f);
     }
 
+    /*
+ random_apply_table<N> caches the cumulative probabilities of the N elements of a tuple :
+ table(i,x,t,f) is equivalent to random_apply(i,x,t,f) without recomputing the normalisation,
+ the element being found by a scan of a small array.
+ refresh(t) must be called whenever the probabilities of the elements change.
+*/
+    template <unsigned int N> class random_apply_table
+    {
+    public:
+        template <typename T> explicit random_apply_table(const T& t) { refresh(t); }
+
+        template <typename T> inline void refresh(const T& t) {
+            detail::random_apply_cumulate<0,N>()(m_cumul,0.,t);
+            m_normalisation = m_cumul[N-1];
+        }
+
+        inline double normalisation() const { return m_normalisation; }
+
+        template <typename T, typename F>
+                inline typename F::result_type operator()(unsigned int& i, double x, T& t, F &f) const {
+            double y = x*m_normalisation;
+            i = 0;
+            while(i<N-1 && y>m_cumul[i]) ++i;
+            return detail::random_apply_at<0,N>()(i,i?(y-m_cumul[i-1]):y,t,f);
+        }
+
+    private:
+        double m_cumul[N];
+        double m_normalisation;
+    };
+
 }; // namespace rjmcmc
 
 #endif // RANDOM_APPLY_HPP
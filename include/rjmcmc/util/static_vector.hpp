@@ -0,0 +1,105 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef RJMCMC_STATIC_VECTOR_HPP
+#define RJMCMC_STATIC_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+namespace rjmcmc {
+
+    // vector with a fixed capacity N and an in-place storage : it never allocates.
+    // only the subset of the std::vector interface used by modifications is provided.
+    template<typename T, unsigned int N>
+    class static_vector
+    {
+    public:
+        typedef T           value_type;
+        typedef T*          iterator;
+        typedef const T*    const_iterator;
+        typedef T&          reference;
+        typedef const T&    const_reference;
+        typedef std::size_t size_type;
+        enum { capacity = N };
+
+        static_vector() : m_size(0) {}
+        static_vector(const static_vector& v) : m_size(0) { for(const_iterator it=v.begin(); it!=v.end(); ++it) push_back(*it); }
+        ~static_vector() { clear(); }
+        static_vector& operator=(const static_vector& v)
+        {
+            if(this==&v) return *this;
+            clear();
+            for(const_iterator it=v.begin(); it!=v.end(); ++it) push_back(*it);
+            return *this;
+        }
+
+        inline size_type size() const { return m_size; }
+        inline bool empty() const { return m_size==0; }
+        inline iterator begin() { return data(); }
+        inline iterator end  () { return data()+m_size; }
+        inline const_iterator begin() const { return data(); }
+        inline const_iterator end  () const { return data()+m_size; }
+        inline reference       operator[](size_type i)       { return data()[i]; }
+        inline const_reference operator[](size_type i) const { return data()[i]; }
+        inline reference       back()       { return data()[m_size-1]; }
+        inline const_reference back() const { return data()[m_size-1]; }
+
+        inline void push_back(const T& t)
+        {
+            assert(m_size<N);
+            new(data()+m_size) T(t);
+            ++m_size;
+        }
+        inline void pop_back() { data()[--m_size].~T(); }
+        inline void clear() { while(m_size) pop_back(); }
+
+    private:
+        inline T*       data()       { return static_cast<T*>(static_cast<void*>(&m_storage)); }
+        inline const T* data() const { return static_cast<const T*>(static_cast<const void*>(&m_storage)); }
+
+        enum { storage_size = (N>0) ? N : 1 };
+        typename boost::aligned_storage<sizeof(T)*storage_size, boost::alignment_of<T>::value>::type m_storage;
+        size_type m_size;
+    };
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_STATIC_VECTOR_HPP
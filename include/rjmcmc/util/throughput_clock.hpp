@@ -0,0 +1,123 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+
+#ifndef RJMCMC_THROUGHPUT_CLOCK_HPP
+#define RJMCMC_THROUGHPUT_CLOCK_HPP
+
+#include "rjmcmc/util/checkpoint.hpp"
+
+#if USE_CPP11
+#include <chrono>
+#else
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#endif
+
+namespace rjmcmc {
+
+    /// monotonic wall clock time, in seconds from an arbitrary origin
+    inline double wall_time()
+    {
+#if USE_CPP11
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+        static const boost::posix_time::ptime origin = boost::posix_time::microsec_clock::universal_time();
+        return (boost::posix_time::microsec_clock::universal_time()-origin).total_microseconds()*1e-6;
+#endif
+    }
+
+    /**
+     * Wall clock that is started by the first tick and only read every few ticks,
+     * the number of ticks between two readings adapting so that they are about `period` seconds apart.
+     * Each reading measures the throughput, in ticks per second, since the previous one.
+     */
+    class throughput_clock
+    {
+    public:
+        throughput_clock(double period = 1e-3)
+            : m_period(period), m_started(false), m_start(0), m_last(0), m_elapsed(0), m_rate(0)
+            , m_interval(1), m_countdown(1) {}
+
+        /// counts a tick and returns whether the clock was read
+        inline bool tick()
+        {
+            if(--m_countdown>0) return false;
+            read();
+            return true;
+        }
+
+        /// number of ticks that may be counted by skip before the next reading
+        inline unsigned int idle_ticks() const { return m_countdown>1 ? m_countdown-1 : 0; }
+        inline void skip(unsigned int n) { m_countdown = (n<idle_ticks()) ? m_countdown-n : 1; }
+
+        /// seconds elapsed between the first tick and the latest reading
+        inline double elapsed() const { return m_elapsed; }
+        /// ticks per second between the two latest readings (0 before the second reading)
+        inline double rate() const { return m_rate; }
+
+        friend void save_state(std::ostream& os, const throughput_clock& c) { rjmcmc::write_binary(os,c.m_elapsed); }
+        friend void load_state(std::istream& is, throughput_clock& c) { rjmcmc::read_binary(is,c.m_elapsed); c.m_started = false; }
+
+    private:
+        void read()
+        {
+            double now = wall_time();
+            if(!m_started)
+            {
+                m_started = true;
+                m_start = now-m_elapsed;
+                m_last = now;
+            }
+            else if(now>m_last)
+                m_rate = m_interval/(now-m_last);
+            double dt = now-m_last;
+            if(dt<0.5*m_period && m_interval<(1u<<20)) m_interval *= 2;
+            else if(dt>2*m_period && m_interval>1)     m_interval /= 2;
+            m_last = now;
+            m_elapsed = now-m_start;
+            m_countdown = m_interval;
+        }
+
+        double m_period;
+        bool m_started;
+        double m_start, m_last, m_elapsed, m_rate;
+        unsigned int m_interval;  // ticks between two readings
+        unsigned int m_countdown; // ticks before the next reading
+    };
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_THROUGHPUT_CLOCK_HPP
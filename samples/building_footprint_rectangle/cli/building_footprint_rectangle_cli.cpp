@@ -46,8 +46,12 @@ typedef parameters< parameter > param;
 
 //[building_footprint_rectangle_cli_visitors
 #include "rjmcmc/rjmcmc/sampler/any_sampler.hpp"
+#include "rjmcmc/rjmcmc/sampler/speculative_sampler.hpp"
+#include "rjmcmc/mpp/domain_decomposition_sampler.hpp"
+#include "rjmcmc/simulated_annealing/chunked_optimize.hpp"
 #include "rjmcmc/simulated_annealing/visitor/any_visitor.hpp"
 #include "rjmcmc/simulated_annealing/visitor/ostream_visitor.hpp"
+#include "rjmcmc/simulated_annealing/visitor/checkpoint_visitor.hpp"
 #ifdef USE_SHP
 # include "rjmcmc/simulated_annealing/visitor/shp_visitor.hpp"
 #endif
@@ -79,10 +83,24 @@ int main(int argc , char** argv)
     end_test      *end ; create_end_test     (p,end);
 
     // test avec les any_*
-    typedef rjmcmc::mt19937_generator Engine;
-    Engine& e = rjmcmc::random();
+    typedef rjmcmc::stream_generator Engine;
+    rjmcmc::engine_factory streams = create_engine_factory(p);
+    std::cout << "Seed : " << streams.seed() << std::endl;
+    Engine e = streams(0);
     typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
     any_sampler sampler(*samp);
+    if(p->get<double>("cell_size")>0)
+    {
+        try {
+            sampler = marked_point_process::domain_decomposition_sampler< ::sampler >(*samp,bbox,p->get<double>("cell_size"),object_extent(p),
+                                                                                      p->get<int>("nbcell_iter"),p->get<int>("threads"));
+        } catch(const std::invalid_argument& ex) {
+            std::cerr << ex.what() << " (" << 2*object_extent(p) << ")" << std::endl;
+            return -1;
+        }
+    }
+    else if(p->get<int>("proposals")>1)
+        sampler = rjmcmc::speculative_sampler<Engine,configuration,::sampler>(*samp,p->get<int>("proposals"),p->get<int>("threads"));
 
     /*< Build and initialize simple visitor which prints some data on the standard output >*/
     typedef simulated_annealing::any_composite_visitor<configuration,any_sampler> any_visitor;
@@ -94,7 +112,45 @@ int main(int argc , char** argv)
     init_visitor(p,visitor);
 
     /*< This is the way to launch the optimization process. Here, the magic happens... >*/
-    simulated_annealing::optimize(e,*conf,sampler,*sch,*end,visitor);
+    int replicas = p->get<int>("replicas");
+    int chains   = p->get<int>("chains");
+    int population = p->get<int>("population");
+    if(replicas>1)
+        simulated_annealing::parallel_tempering::optimize(e,*conf,sampler,*sch,*end,visitor,
+                                                           replicas,p->get<double>("replica_ratio"),p->get<int>("nbexchange"));
+    else if(population>1)
+    {
+        simulated_annealing::population_annealing::population_statistics stats =
+                simulated_annealing::population_annealing::optimize(e,*conf,sampler,*sch,*end,visitor,
+                                                                    population,p->get<int>("nbsweep"),p->get<int>("threads"));
+        std::cout << "Resamplings : " << stats.steps << ", copies : " << stats.copies
+                  << ", log(Z_final/Z_initial) : " << stats.log_partition_ratio << std::endl;
+    }
+    else if(chains>1)
+    {
+        std::vector<simulated_annealing::chain_statistics> stats =
+                simulated_annealing::multi_chain_optimize(e,*conf,sampler,*sch,*end,chains,p->get<int>("threads"),
+                                                          p->get<int>("nbcheckpoint"),p->get<double>("racing_margin"));
+        std::cout << std::setw(10) << "Chain" << std::setw(20) << "Iterations" << std::setw(20) << "Energy" << std::setw(10) << "Killed" << std::endl;
+        for(unsigned int i=0; i<stats.size(); ++i)
+            std::cout << std::setw(10) << i << std::setw(20) << stats[i].iterations << std::setw(20) << stats[i].energy << std::setw(10) << stats[i].killed << std::endl;
+        visitor.begin(*conf,sampler,**sch);
+        visitor.end(*conf,sampler,**sch);
+    }
+    else
+    {
+        /*< The sequential optimization may be checkpointed every few iterations and resumed from such a checkpoint >*/
+        simulated_annealing::checkpoint_visitor<any_visitor,Engine,schedule,end_test> checkpointer(visitor,e,*sch,*end,
+                p->get<boost::filesystem::path>("checkpoint-file").string(),p->get<int>("checkpoint-every"));
+        std::string resume = p->get<boost::filesystem::path>("resume").string();
+        if(resume!="" && !checkpointer.resume(resume,*conf,sampler))
+            std::cerr << "Unable to resume from the checkpoint " << resume << std::endl;
+        else
+        {
+            simulated_annealing::kernel_statistics stats;
+            simulated_annealing::chunked_optimize(e,*conf,sampler,*sch,*end,checkpointer,stats);
+        }
+    }
 
     /*< Finally release all dynamically allocated resources >*/
     if(conf) {delete conf; conf=NULL;}
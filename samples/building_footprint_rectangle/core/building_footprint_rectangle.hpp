@@ -110,10 +110,12 @@ typedef simulated_annealing::max_iteration_end_test     end_test;
 #include "rjmcmc/mpp/energy/image_center_unary_energy.hpp"
 typedef oriented<boost::gil::gray16_image_t> mask_type;
 #include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
 typedef marked_point_process::graph_configuration<
         object,
         minus_energy<constant_energy<>,multiplies_energy<constant_energy<>,unary_energy> >,
-        multiplies_energy<constant_energy<>,binary_energy>
+        multiplies_energy<constant_energy<>,binary_energy>,
+        marked_point_process::grid_accelerator
         > configuration;
 //]
 
@@ -166,6 +168,21 @@ void set_bbox(param *p, const Iso_rectangle_2& r) {
 }
 //]
 
+// maximum distance from the center of a birth to its boundary
+double object_extent(const param *p) {
+    double maxsize  = p->get<double>("maxsize");
+    double maxratio = p->get<double>("maxratio");
+    return maxsize*std::sqrt(2.*(1.+maxratio*maxratio));
+}
+
+//[building_footprint_rectangle_create_engine_factory
+/*< Engines are streams of a factory seeded from the parameters, a null seed being first replaced by a time-based seed so that the run may be reproduced >*/
+rjmcmc::engine_factory create_engine_factory(param *p) {
+    if(!p->get<int>("seed")) p->set("seed",int(rjmcmc::time_seed()&0x7fffffff));
+    return rjmcmc::engine_factory(p->get<int>("seed"));
+}
+//]
+
 //[building_footprint_rectangle_create_configuration
 #include "rjmcmc/image/conversion_functor.hpp"
 #include <boost/gil/extension/io_new/tiff_write.hpp>
@@ -194,14 +211,16 @@ void create_configuration(const param *p, const oriented_gradient_image& grad, c
         boost::gil::write_view( mask_file+"_y.tif" , boost::gil::nth_channel_view(grad.view(),1), boost::gil::tiff_tag() );
     }
 
-    // empty initial configuration
+    // empty initial configuration, whose interactions are looked up in a grid of cells of the size of the largest births
+    double extent   = object_extent(p);
     c = new configuration( p->get<double>("energy")-(p->get<double>("ponderation_grad")*unary_energy(grad)),
-                           p->get<double>("ponderation_surface")*binary_energy());
+                           p->get<double>("ponderation_surface")*binary_energy(),
+                           marked_point_process::grid_accelerator(get_bbox(p),extent));
 }
 //]
 
 //[building_footprint_rectangle_create_sampler
-void create_sampler(const param *p, sampler *&s) {
+void create_sampler(param *p, sampler *&s) {
     Iso_rectangle_2 r = get_bbox(p);
     double maxsize  = p->get<double>("maxsize");
     double maxratio = p->get<double>("maxratio");
@@ -234,8 +253,7 @@ void create_sampler(const param *p, sampler *&s) {
 
     d_sampler ds( cs, birth );
 
-    typedef rjmcmc::mt19937_generator Engine;
-    Engine& e = rjmcmc::random();
+    rjmcmc::stream_generator e = create_engine_factory(p)(1); // resolves a null seed first
     marked_point_process::graph_configuration<object, constant_energy<>, constant_energy<> > c(1,1);
     ds(e,c);
     double p_birthdeath  = p->get<double>("p_birthdeath");
@@ -330,6 +348,9 @@ void init_visitor(const param *p, Visitor& v)
 
 //[building_footprint_rectangle_optimization
 #include "rjmcmc/simulated_annealing/simulated_annealing.hpp"
+#include "rjmcmc/simulated_annealing/parallel_tempering.hpp"
+#include "rjmcmc/simulated_annealing/multi_chain.hpp"
+#include "rjmcmc/simulated_annealing/population_annealing.hpp"
 //]
 
 #endif // BUILDING_FOOTPRINT_RECTANGLE_HPP
@@ -53,6 +53,21 @@ void initialize_parameters(T* params)
     params->template insert<int>("nbdump",'d',10000,"Number of iterations between each result display");
 //    params->template insert<bool>("dosave",'b',false, "Save intermediate results");
     params->template insert<int>("nbsave",'S',100000,"Number of iterations between each save");
+    params->template insert<int>("replicas",'\0',1,"Number of parallel tempering replicas (1: plain simulated annealing)");
+    params->template insert<double>("replica_ratio",'\0',1.5,"Temperature ratio between adjacent replicas");
+    params->template insert<int>("nbexchange",'\0',1000,"Number of iterations between each replica exchange");
+    params->template insert<int>("chains",'\0',1,"Number of independent chains, the best one being kept");
+    params->template insert<int>("threads",'\0',0,"Number of threads running the chains (0: hardware threads)");
+    params->template insert<int>("nbcheckpoint",'\0',0,"Number of iterations between each chain racing checkpoint (0: no racing)");
+    params->template insert<double>("racing_margin",'\0',1000,"Energy margin above the best chain at a checkpoint before a chain is stopped");
+    params->template insert<int>("population",'\0',1,"Number of population annealing replicas (1: plain simulated annealing)");
+    params->template insert<int>("nbsweep",'\0',1000,"Number of iterations of each population annealing replica between each resampling");
+    params->template insert<double>("cell_size",'\0',0,"Cell size of the parallel domain decomposition, larger than twice the object extent (0: no decomposition)");
+    params->template insert<int>("nbcell_iter",'\0',1000,"Number of iterations per cell in each phase of a domain decomposition sweep");
+    params->template insert<int>("proposals",'\0',1,"Number of proposals evaluated speculatively in parallel (1: no speculation)");
+    params->template insert<int>("checkpoint-every",'\0',0,"Number of iterations between each checkpoint of the optimization (0: no checkpoint)");
+    params->template insert<boost::filesystem::path>("checkpoint-file",'\0',"checkpoint.bin","Checkpoint file path");
+    params->template insert<boost::filesystem::path>("resume",'\0',"","Checkpoint file to resume the optimization from, with the same parameters");
     params->template insert<double>("poisson",'p',100, "Poisson processus parameter");
     params->template insert<double>("maxsize",'m',20, "Maximum rectangle size");
     params->template insert<double>("maxratio",'M',5, "Maximum rectangle aspect ratio");
@@ -77,6 +92,7 @@ void initialize_parameters(T* params)
 //    params->template insert<int>("subsampling",'u',1, "Subsampling");
 //    params->template insert<double>("gaussian",'g',2, "Gaussian filter variance");
     params->template insert<double>("sigmaD",'G',1, "Kernel size for gradients computation");
+    params->template insert<int>("seed",'\0',0, "Random seed (0: time-based seed)");
 }
 //]
 
@@ -82,7 +82,7 @@ class building_footprint_rectangle_gilviewer : public wx_plugin_base, public sim
     //]
 
 private:
-    typedef rjmcmc::mt19937_generator Engine;
+    typedef rjmcmc::stream_generator Engine;
     typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
     typedef simulated_annealing::any_composite_visitor<configuration,any_sampler> any_composite_visitor;
 
@@ -199,7 +199,7 @@ public:
         //    m_config->clear();
 
         any_sampler *sampler = new any_sampler(*m_sampler);
-        Engine& e = rjmcmc::random();
+        Engine e = create_engine_factory(m_param)(0);
 
         m_thread = new boost::thread(
                 simulated_annealing::optimize<Engine,configuration,any_sampler,schedule,end_test,any_composite_visitor>,
@@ -205,8 +205,8 @@ public:
       //  std::cout << "Salamon initial schedule : " << salamon_initial_schedule(m_sampler->density(),*m_config,1000) << std::endl;
         m_config->clear();
 
-        typedef rjmcmc::mt19937_generator Engine;
-        Engine& e = rjmcmc::random();
+        typedef rjmcmc::stream_generator Engine;
+        Engine e = create_engine_factory(m_param)(0);
         typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
 
         typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
@@ -109,6 +109,7 @@ int main(int argc , char** argv)
     double deccoef  = (++i<argc) ? atof(argv[i]) : 0.999999;
     int nbdump      = (++i<argc) ? atoi(argv[i]) : 1000000;
     int nbsave      = (++i<argc) ? atoi(argv[i]) : 1000000;
+    unsigned long seed = (++i<argc) ? strtoul(argv[i],NULL,10) : (unsigned long) rjmcmc::time_seed();
     //]
 
     //[optimize
@@ -140,8 +141,9 @@ int main(int argc , char** argv)
     simulated_annealing::composite_visitor< simulated_annealing::ostream_visitor,simulated_annealing::tex_visitor> visitor(osvisitor,texvisitor);
 #endif
 
-    typedef rjmcmc::mt19937_generator Engine;
-    Engine& e = rjmcmc::random();
+    typedef rjmcmc::stream_generator Engine;
+    std::cout << "Seed : " << seed << std::endl;
+    Engine e = rjmcmc::engine_factory(seed)(0);
 
     visitor.init(nbdump,nbsave);
     simulated_annealing::optimize(e,c,samp,sch,end,visitor);
@@ -0,0 +1,60 @@
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> object;
+#include "rjmcmc/geometry/coordinates/Rectangle_2_coordinates.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth_death_kernel.hpp"
+#include "rjmcmc/mpp/kernel/uniform_kernel.hpp"
+#include "rjmcmc/geometry/transform/rectangle_split_merge_transform.hpp"
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/rjmcmc/distribution/poisson_distribution.hpp"
+#include "rjmcmc/mpp/direct_sampler.hpp"
+#include "rjmcmc/rjmcmc/acceptance/metropolis_acceptance.hpp"
+#include "rjmcmc/rjmcmc/sampler/sampler.hpp"
+
+typedef marked_point_process::uniform_birth<object>                                     uniform_birth;
+typedef marked_point_process::uniform_birth_death_kernel<uniform_birth>::type           birth_death_kernel;
+typedef geometry::rectangle_split_merge_transform_v2                                    split_merge_transform;
+typedef marked_point_process::uniform_kernel<object,1,2,split_merge_transform>::type    split_merge_kernel;
+typedef marked_point_process::graph_configuration<object, constant_energy<>, constant_energy<> > configuration;
+typedef marked_point_process::direct_sampler<rjmcmc::poisson_distribution,uniform_birth> d_sampler;
+typedef rjmcmc::sampler<d_sampler,rjmcmc::metropolis_acceptance,birth_death_kernel,split_merge_kernel> sampler;
+typedef rjmcmc::stream_generator Engine;  // source of randomness
+
+// null energies : the cost of an iteration is dominated by the proposal, including the storage of the modification
+template<typename Modification> void bench(const char *name, sampler s, int iter)
+{
+    Engine e = rjmcmc::engine_factory(42)(0);
+    configuration c(0,0);
+    std::clock_t begin = std::clock();
+    for(int i=0; i<iter; ++i)
+    {
+        Modification modif;
+        s.propose(e,c,modif);
+        s.accept(e,c,modif,1.);
+    }
+    double seconds = double(std::clock()-begin)/CLOCKS_PER_SEC;
+    std::cout << name << " : " << iter/seconds << " iterations/s (" << c.size() << " objects)" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int iter = 10000000;
+    if(argc>1) iter = atoi(argv[1]);
+
+    K::Vector_2 v(20,20);
+    uniform_birth birth(object(K::Point_2(0,0),-v,0.2), object(K::Point_2(1000,1000),v,5));
+    sampler s(d_sampler(rjmcmc::poisson_distribution(100), birth), rjmcmc::metropolis_acceptance(),
+              marked_point_process::make_uniform_birth_death_kernel(birth,1.,0.5),
+              marked_point_process::make_uniform_kernel<object,1,2>(split_merge_transform(),1.,0.5));
+
+    bench<configuration::modification>("std::vector modification  ",s,iter);
+    bench<configuration::bounded_modification<sampler::max_modification_size>::type>("static_vector modification",s,iter);
+    return 0;
+}
@@ -22,7 +22,7 @@ int main(int argc, char **argv)
     int size[] = {5,6};
 
     Variate var(value,size);
-    Engine& engine = rjmcmc::random();
+    Engine engine(boost::uint32_t(rjmcmc::time_seed()));
 
 //    int count[] = {0,0,0, 0,0,0};
 
@@ -25,7 +25,7 @@ template<typename Normalizer> void test(int iter, const Normalizer& normalizer)
     Test test;
     rjmcmc::rejection_variate<Variate,Test,Normalizer> rej(var,test,normalizer);
 
-    Engine& engine = rjmcmc::random();
+    Engine engine(boost::uint32_t(rjmcmc::time_seed()));
     double val[2];
     // repeated sampling
     for(int i=0; i<iter; ++i)